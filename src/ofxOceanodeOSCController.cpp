@@ -7,12 +7,95 @@
 
 #include "ofxOceanodeOSCController.h"
 #include "ofxOceanodeContainer.h"
+#include "oscTrace.h"
+#include "oscResolver.h"
 #include "imgui.h"
 
+#include <arpa/inet.h>
+
+//-------------------------------------------------------------------------
+// oscSharedSender
+//-------------------------------------------------------------------------
+
+oscSharedSender::oscSharedSender(const std::string &_hosts, int _port) : hosts(_hosts), port(_port){
+    sender.setup(hosts, port);
+}
+
+void oscSharedSender::queue(const ofxOscMessage &message){
+    if(target){
+        target->queue(message);
+        return;
+    }
+    // While the host resolves only the latest message of each address waits
+    if(!sender.isReady()){
+        for(auto &queued : pending){
+            if(queued.getAddress() == message.getAddress()){
+                queued = message;
+                return;
+            }
+        }
+    }
+    pending.push_back(message);
+}
+
+void oscSharedSender::flush(){
+    if(target) return;
+    // Kept until a destination resolves, so the resend of a preset loaded at startup is not lost
+    if(!pending.empty() && sender.isReady()){
+        sender.sendMessages(pending);
+        pending.clear();
+    }
+    sender.update();
+}
+
+// Destinations with plain hosts resolved to numbers, in a stable order.
+// resolving is set when a name has no address yet and kept as written.
+static std::string resolvedKey(const std::string &hosts, int port, bool &resolving){
+    std::vector<std::string> parts;
+    resolving = false;
+    for(auto &endpoint : oscEndpoint::fromHostList(hosts, port)){
+        oscSocketAddress address;
+        bool retry = false;
+        if(endpoint.isUnix() || endpoint.isTcp() || !oscSocketAddress::resolve(endpoint, address, &retry) || address.storage.ss_family != AF_INET){
+            resolving |= retry;
+            parts.push_back(endpoint.toString());
+            continue;
+        }
+        char numeric[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in*>(&address.storage)->sin_addr, numeric, sizeof(numeric));
+        parts.push_back(std::string(numeric) + ":" + ofToString(endpoint.port));
+    }
+    std::sort(parts.begin(), parts.end());
+    parts.erase(std::unique(parts.begin(), parts.end()), parts.end());
+    return ofJoinString(parts, ",");
+}
+
+//-------------------------------------------------------------------------
+// ofxOceanodeOSCController
+//-------------------------------------------------------------------------
+
 ofxOceanodeOSCController::ofxOceanodeOSCController(ofParameter<int> & _receiverPort) : ofxOceanodeBaseController("OSC"){
     receiverPortParam = std::make_shared<ofParameter<int>>(_receiverPort);
     receiverPortParam->set(12345);
     json = ofLoadJson("OscConfig.json");
+    
+    // After the app update, so what nodes sent during it leaves this frame
+    updateListener = ofEvents().update.newListener([this](ofEventArgs &){
+        OSC_TRACE_SCOPE("oscSender.flush");
+        for(auto pooled = senderPool.begin(); pooled != senderPool.end();){
+            if(auto sender = pooled->second.lock()){
+                sender->flush();
+                ++pooled;
+            }else{
+                pooled = senderPool.erase(pooled);
+            }
+        }
+        rekeySenders();
+    }, OF_EVENT_ORDER_AFTER_APP);
+    
+    receiverPortListener = receiverPortParam->newListener([this](int &){
+        if(!receiverRoutes.empty()) openReceiver();
+    });
 }
 
 ofxOceanodeOSCController::~ofxOceanodeOSCController(){
@@ -51,6 +134,40 @@ void ofxOceanodeOSCController::draw(){
             ImGui::TreePop();
         }
     }
+    if(!senderPool.empty()){
+        ImGui::Text("Sender sockets:");
+        for(auto &pooled : senderPool){
+            if(auto sender = pooled.second.lock()){
+                // Nodes using it, the pool's own reference is weak
+                ImGui::Text("  %s (%ld)", pooled.first.c_str(), sender.use_count() - 1);
+            }
+        }
+    }
+    if(!receiverRoutes.empty()){
+        ImGui::Text("Receiver port %d: %zu nodes", receiverPortParam->get(), receiverRoutes.size());
+    }
+    // Host names are looked up in the background, failures show here instead of blocking
+    auto resolved = oscResolver::shared().getEntries();
+    if(!resolved.empty() && ImGui::TreeNode("Hosts")){
+        for(auto &entry : resolved){
+            switch(entry.status){
+                case oscResolver::Status::Pending:
+                    ImGui::Text("%s: resolving", entry.host.c_str());
+                    break;
+                case oscResolver::Status::Resolved:
+                    ImGui::Text("%s: %s (%llus ago)", entry.host.c_str(), entry.address.c_str(), (unsigned long long)entry.age / 1000);
+                    break;
+                case oscResolver::Status::Failed:
+                    ImGui::TextColored(ImVec4(1, 0.4, 0.4, 1), "%s: %s", entry.host.c_str(), entry.error.c_str());
+                    break;
+            }
+            if(entry.status == oscResolver::Status::Resolved && !entry.error.empty()){
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1, 0.7, 0.3, 1), "refresh failed: %s", entry.error.c_str());
+            }
+        }
+        ImGui::TreePop();
+    }
     if(ImGui::Selectable("SAVE")){
         save();
     }
@@ -69,3 +186,91 @@ string ofxOceanodeOSCController::addSender(string name){
     //Send host and ports
     return hosts[name];
 }
+
+std::shared_ptr<oscSharedSender> ofxOceanodeOSCController::acquireSender(const std::string &hosts, int port){
+    bool resolving;
+    std::string key = resolvedKey(hosts, port, resolving);
+    auto &pooled = senderPool[key];
+    if(auto sender = pooled.lock()){
+        return sender;
+    }
+    auto sender = std::make_shared<oscSharedSender>(hosts, port);
+    sender->key = key;
+    sender->keyResolving = resolving;
+    pooled = sender;
+    return sender;
+}
+
+void ofxOceanodeOSCController::rekeySenders(){
+    std::vector<std::shared_ptr<oscSharedSender>> resolved;
+    for(auto &pooled : senderPool){
+        auto sender = pooled.second.lock();
+        if(sender && sender->keyResolving && !sender->isResolving()) resolved.push_back(sender);
+    }
+    for(auto &sender : resolved){
+        bool resolving;
+        std::string key = resolvedKey(sender->hosts, sender->port, resolving);
+        sender->keyResolving = resolving;
+        if(key == sender->key) continue;
+        senderPool.erase(sender->key);
+        sender->key = key;
+        auto &pooled = senderPool[key];
+        if(auto existing = pooled.lock()){
+            // Same destination as a sender made for its address, or another spelling of it
+            existing->pending.insert(existing->pending.end(), sender->pending.begin(), sender->pending.end());
+            sender->pending.clear();
+            sender->sender.clear();
+            sender->target = existing;
+        }else{
+            pooled = sender;
+        }
+    }
+}
+
+void ofxOceanodeOSCController::addReceiverRoute(const std::string &name, const void *owner, std::function<void(const ofxOscMessage&)> callback){
+    receiverRoutes[name].push_back({owner, callback});
+    if(!receiver.isListening()){
+        openReceiver();
+        receiveListener = ofEvents().update.newListener([this](ofEventArgs &){
+            dispatchReceived();
+        }, OF_EVENT_ORDER_BEFORE_APP);
+    }
+}
+
+void ofxOceanodeOSCController::removeReceiverRoutes(const void *owner){
+    for(auto routes = receiverRoutes.begin(); routes != receiverRoutes.end();){
+        auto &list = routes->second;
+        list.erase(std::remove_if(list.begin(), list.end(), [owner](const ReceiverRoute &route){
+            return route.owner == owner;
+        }), list.end());
+        routes = list.empty() ? receiverRoutes.erase(routes) : std::next(routes);
+    }
+    if(receiverRoutes.empty()){
+        receiveListener.unsubscribe();
+        receiver.stop();
+        received.clear();
+    }
+}
+
+void ofxOceanodeOSCController::openReceiver(){
+    receiver.stop();
+    if(!receiver.setup(receiverPortParam->get())){
+        ofLogError("ofxOceanodeOSCController") << "Could not listen on port " << receiverPortParam->get();
+    }
+}
+
+void ofxOceanodeOSCController::dispatchReceived(){
+    OSC_TRACE_SCOPE("oscReceiver.dispatch");
+    if(!receiver.takeMessages(received)) return;
+    for(auto &message : received){
+        // "/name/parameter" and "/name" both route on name
+        const std::string &address = message.getAddress();
+        if(address.size() < 2) continue;
+        size_t separator = address.find('/', 1);
+        auto routes = receiverRoutes.find(address.substr(1, separator == std::string::npos ? std::string::npos : separator - 1));
+        if(routes == receiverRoutes.end()) continue;
+        for(auto &route : routes->second){
+            route.callback(message);
+        }
+    }
+}
@@ -9,6 +9,41 @@
 #define ofxOceanodeOSCController_h
 
 #include "ofxOceanodeBaseController.h"
+#include "oscTransport.h"
+
+// One socket for every oscSender node sending to the same destination.
+// Messages queued during a frame leave together, packed in as few
+// datagrams as possible, when the controller flushes after the app update.
+class oscSharedSender {
+public:
+    oscSharedSender(const std::string &hosts, int port);
+    // Whatever is still queued goes out
+    ~oscSharedSender() {flush();};
+    
+    void queue(const ofxOscMessage &message);
+    // Sends what was queued and flushes TCP streams. Nothing is sent, and
+    // nothing dropped, until the sender has a destination to send to.
+    void flush();
+    
+    bool isReady() const {return target ? target->isReady() : sender.isReady();};
+    // Waiting for a host name, see oscResolver.h
+    bool isResolving() const {return !target && sender.isResolving();};
+    const std::string &getKey() const {return key;};
+    size_t getNumQueued() const {return pending.size();};
+    
+private:
+    friend class ofxOceanodeOSCController;
+    std::string hosts;
+    int port;
+    std::string key;
+    // The key was made while a name was still resolving, see ofxOceanodeOSCController::rekeySenders
+    bool keyResolving = false;
+    oscTransportSender sender;
+    std::vector<ofxOscMessage> pending;
+    // Pooled sender that turned out to have the same destination, everything
+    // queued goes there and our own socket is closed
+    std::shared_ptr<oscSharedSender> target;
+};
 
 class ofxOceanodeOSCController : public ofxOceanodeBaseController{
 public:
@@ -21,11 +56,42 @@ public:
     
     string addSender(string name);
     
+    // Shared sender for the resolved destination, created on first use. The
+    // socket closes once the last node holding it lets go.
+    std::shared_ptr<oscSharedSender> acquireSender(const std::string &hosts, int port);
+    
+    // Messages to "/name" or "/name/..." on the controller's receiver port go
+    // to callback on the main thread, before the app update. The port opens
+    // with the first route, every oscReceiver node shares it.
+    void addReceiverRoute(const std::string &name, const void *owner, std::function<void(const ofxOscMessage&)> callback);
+    void removeReceiverRoutes(const void *owner);
+    
     map<string, ofEvent<string>> hostEvents;
 private:
+    struct ReceiverRoute {
+        const void *owner;
+        std::function<void(const ofxOscMessage&)> callback;
+    };
+    void openReceiver();
+    void dispatchReceived();
+    // Moves senders created for a pending name to the key of its address
+    void rekeySenders();
+    
     shared_ptr<ofParameter<int>> receiverPortParam;
     map<string, string> hosts;
     
+    // Keyed by resolved destination, so "localhost" and "127.0.0.1" share a socket.
+    // Senders made while a name was resolving are re-keyed once it has an address.
+    std::map<std::string, std::weak_ptr<oscSharedSender>> senderPool;
+    ofEventListener updateListener;
+    
+    // Keyed by the first address segment, one entry per receiving node name
+    std::unordered_map<std::string, std::vector<ReceiverRoute>> receiverRoutes;
+    oscTransportReceiver receiver;
+    std::deque<ofxOscMessage> received;
+    ofEventListener receiveListener;
+    ofEventListener receiverPortListener;
+    
     ofJson json;
 };
 
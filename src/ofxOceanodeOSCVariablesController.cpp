@@ -32,6 +32,17 @@ oscVariablesGroup::oscVariablesGroup(std::string _name,
 
 oscVariablesGroup::~oscVariablesGroup() 
 {
+    // The receive and playback threads must not reach the table, or the
+    // recorder, while members go away
+    receiver.setObserver(nullptr);
+    stopRecording();
+    player.stop();
+    
+    // The store writes it before its thread exits
+    if(persistValues) {
+        checkpointValues(true);
+    }
+    
     // Delete all existing nodes
     for(auto &node : nodes) {
         node->deleteSelf();
@@ -73,93 +84,211 @@ void oscVariablesGroup::addNode(oscVariables *node) {
     }
     node->addParameter(portParam, ofxOceanodeParameterFlags_DisableSavePreset | ofxOceanodeParameterFlags_ReadOnly);
     
-    for(int i = 0; i < parameters.size(); i++) {
-        ofAbstractParameter& param = *parameters[i];
+    auto table = getParameters();
+    for(int i = 0; i < table->variables.size(); i++) {
+        ofAbstractParameter& param = *table->variables[i].parameter;
         // Try using explicit flag value
         ofxOceanodeParameterFlags flags = ofxOceanodeParameterFlags_DisableSavePreset;
         node->addParameter(param, flags);
     }
+    
+    if(packed) {
+        addPackedOutputs(node);
+    }
 }
 
-void oscVariablesGroup::removeNode(oscVariables *node){
-    nodes.erase(std::remove(nodes.begin(), nodes.end(), node), nodes.end());
+void oscVariablesGroup::setPacked(bool enabled) {
+    if(enabled == packed) return;
+    packed = enabled;
+    if(packed) {
+        packedFloats.set("Packed Floats", std::vector<float>());
+        packedInts.set("Packed Ints", std::vector<int>());
+        packedStrings.set("Packed Strings", std::vector<std::string>());
+        packedFloatValues.clear();
+        packedIntValues.clear();
+        packedStringValues.clear();
+        updatePacked(*getParameters());
+    }
+    for(auto &node : nodes) {
+        if(packed) {
+            addPackedOutputs(node);
+        } else {
+            node->removeParameter(packedFloats.getName());
+            node->removeParameter(packedInts.getName());
+            node->removeParameter(packedStrings.getName());
+        }
+    }
 }
 
-void oscVariablesGroup::addFloatParameter(std::string parameterName, float value){
-    ofParameter<float> tempParam;
-    parameters.push_back(tempParam.set(parameterName, value, -FLT_MAX, FLT_MAX).newReference());
-    for(auto &node : nodes){
-        node->addParameter(tempParam,ofxOceanodeParameterFlags_DisableSavePreset);
+size_t oscVariablesGroup::createLearnedVariables() {
+    size_t created = 0;
+    for (auto &entry : learned.getEntries()) {
+        // Protocol addresses and names taken in the meantime are skipped
+        if (entry.address.empty() || entry.address[0] == '_' || getParameters()->find(entry.address) != nullptr) continue;
+        auto type = oscVariableTypes::infer(entry.typeTags, entry.maxArgs, entry.mixed);
+        if (type == nullptr) {
+            ofLogWarning("oscVariablesGroup") << "No variable type for " << entry.address << " ,"<< entry.typeTags;
+            continue;
+        }
+        addParameter(entry.address, *type);
+        created++;
     }
+    learned.clear();
+    return created;
+}
+
+void oscVariablesGroup::addPackedOutputs(oscVariables *node) {
+    ofxOceanodeParameterFlags flags = ofxOceanodeParameterFlags_DisableSavePreset | ofxOceanodeParameterFlags_ReadOnly;
+    node->addParameter(packedFloats, flags);
+    node->addParameter(packedInts, flags);
+    node->addParameter(packedStrings, flags);
 }
 
-void oscVariablesGroup::addFloatVectorParameter(std::string parameterName, std::vector<float> value) {
-    // Create and properly initialize the parameter
-    ofParameter<vector<float>> tempParam;
-    vector<float> defaultVal = {0};
-    vector<float> minVal = {FLT_MIN};     // min values
-    vector<float> maxVal = {FLT_MAX};     // max values
+void oscVariablesGroup::updatePacked(const oscParameterTable &table) {
+    OSC_TRACE_SCOPE("osc.packed");
+    bool floatsChanged = packedFloatValues.size() != table.numPackedFloats;
+    bool intsChanged = packedIntValues.size() != table.numPackedInts;
+    bool stringsChanged = packedStringValues.size() != table.numPackedStrings;
+    packedFloatValues.resize(table.numPackedFloats);
+    packedIntValues.resize(table.numPackedInts);
+    packedStringValues.resize(table.numPackedStrings);
     
-    // Use set() to properly initialize with name, default, min, and max values
-    tempParam.set(parameterName, value, minVal, maxVal);
-    tempParam.setSerializable(true);
-    // Now add the reference to our parameters list
-    parameters.push_back(std::make_shared<ofParameter<std::vector<float>>>(tempParam));
-    // And add to all nodes
-    for(auto &node : nodes) {
-        if(node != nullptr) {
-            node->addParameter(tempParam, ofxOceanodeParameterFlags_DisableSavePreset);
+    for(auto &variable : table.variables) {
+        switch(variable.type->lane) {
+            case oscPackedLane::Float: {
+                float value = static_cast<const ofParameter<float>&>(*variable.parameter).get();
+                float &slot = packedFloatValues[variable.packedIndex];
+                if(slot != value) {
+                    slot = value;
+                    floatsChanged = true;
+                }
+                break;
+            }
+            case oscPackedLane::Int: {
+                int value = static_cast<const ofParameter<int>&>(*variable.parameter).get();
+                int &slot = packedIntValues[variable.packedIndex];
+                if(slot != value) {
+                    slot = value;
+                    intsChanged = true;
+                }
+                break;
+            }
+            case oscPackedLane::String: {
+                const std::string &value = static_cast<const ofParameter<std::string>&>(*variable.parameter).get();
+                std::string &slot = packedStringValues[variable.packedIndex];
+                if(slot != value) {
+                    slot = value;
+                    stringsChanged = true;
+                }
+                break;
+            }
+            case oscPackedLane::None:
+                break;
         }
     }
+    
+    // Assigning to a vector of the same size reuses its storage
+    if(floatsChanged) packedFloats = packedFloatValues;
+    if(intsChanged) packedInts = packedIntValues;
+    if(stringsChanged) packedStrings = packedStringValues;
 }
 
-void oscVariablesGroup::addIntParameter(std::string parameterName, int value) {
-    ofParameter<int> tempParam;
-    parameters.push_back(tempParam.set(parameterName, value, INT_MIN, INT_MAX).newReference());
-    for(auto &node : nodes) {
-        node->addParameter(tempParam, ofxOceanodeParameterFlags_DisableSavePreset);
-    }
+void oscVariablesGroup::removeNode(oscVariables *node){
+    nodes.erase(std::remove(nodes.begin(), nodes.end(), node), nodes.end());
 }
 
-void oscVariablesGroup::addIntVectorParameter(std::string parameterName, std::vector<int> value) {
-    ofParameter<vector<int>> tempParam;
-    vector<int> defaultVal = {0};
-    vector<int> minVal = {INT_MIN};
-    vector<int> maxVal = {INT_MAX};
-    
-    tempParam.set(parameterName, value, minVal, maxVal);
-    tempParam.setSerializable(true);
-    parameters.push_back(std::make_shared<ofParameter<std::vector<int>>>(tempParam));
-    for(auto &node : nodes) {
+void oscVariablesGroup::addParameter(const std::string &parameterName, const oscVariableType &type){
+    oscVariable variable;
+    variable.parameter = type.create(parameterName);
+    variable.type = &type;
+    variable.name = parameterName;
+    variable.searchKey = ofToLower(parameterName);
+    publishParameters([&variable](auto &variables){variables.push_back(variable);});
+    for(auto &node : nodes){
         if(node != nullptr) {
-            node->addParameter(tempParam, ofxOceanodeParameterFlags_DisableSavePreset);
+            node->addParameter(*variable.parameter, ofxOceanodeParameterFlags_DisableSavePreset);
         }
     }
 }
 
-void oscVariablesGroup::addStringParameter(std::string parameterName, std::string value){
-    ofParameter<std::string> tempParam;
-    parameters.push_back(tempParam.set(parameterName, value).newReference());
+void oscVariablesGroup::removeParameter(std::string parameterName){
+    setParameterMonitored(parameterName, false);
     for(auto &node : nodes){
-        node->addParameter(tempParam,ofxOceanodeParameterFlags_DisableSavePreset);
+        node->removeParameter(parameterName);
     }
+    reliableParameters.erase(parameterName);
+    publishParameters([&parameterName](auto &variables){
+        variables.erase(std::remove_if(variables.begin(), variables.end(), [&parameterName](auto &variable){return variable.name == parameterName;}), variables.end());
+    });
 }
 
-
-void oscVariablesGroup::addStringVectorParameter(std::string parameterName, std::vector<string> value) {
-    ofParameter<std::vector<string>> tempParam;
-    parameters.push_back(tempParam.set(parameterName, value).newReference());
-    for(auto &node : nodes){
-        node->addParameter(tempParam, ofxOceanodeParameterFlags_DisableSavePreset);
+bool oscVariablesGroup::applyConfig(const oscGroupConfig &config){
+    bool rebind = transport != config.transport || portParam.get() != config.port || ipParam.get() != config.host
+        || multicastTtl != config.multicastTtl || multicastInterface != config.multicastInterface || multicastGroups != config.multicastGroups;
+    transport = config.transport;
+    portParam.set(config.port);
+    ipParam.set(config.host);
+    multicastTtl = config.multicastTtl;
+    multicastInterface = config.multicastInterface;
+    multicastGroups = config.multicastGroups;
+    
+    // Everything else is applied to the live socket
+    if(receiveBufferSize != config.receiveBufferSize){
+        receiveBufferSize = config.receiveBufferSize;
+        if(oscMode == OscMode::Receiver) receiver.setReceiveBufferSize(receiveBufferSize);
+    }
+    if(sendBufferSize != config.sendBufferSize){
+        sendBufferSize = config.sendBufferSize;
+        if(oscMode == OscMode::Sender) sender.setSendBufferSize(sendBufferSize);
     }
+    if(sequencing != config.sequencing){
+        sequencing = config.sequencing;
+        sender.setSequencing(sequencing);
+    }
+    if(snapshots != config.snapshots){
+        snapshots = config.snapshots;
+        sender.setSnapshots(snapshots);
+        receiver.setSnapshotRequests(snapshots);
+    }
+    framed = config.framed;
+    setPacked(config.packed);
+    persistValues = config.persistValues;
+    
+    // Variables that are gone or changed type go first, so nodes keep the connections of all the others
+    auto table = getParameters();
+    for(auto &variable : table->variables){
+        const std::string &parameterName = variable.parameter->getName();
+        auto wanted = std::find_if(config.variables.begin(), config.variables.end(), [&parameterName](auto &wanted){return wanted.name == parameterName;});
+        if(wanted == config.variables.end() || wanted->type != variable.type){
+            removeParameter(parameterName);
+        }
+    }
+    for(auto &variable : config.variables){
+        if(getParameters()->find(variable.name) == nullptr){
+            addParameter(variable.name, *variable.type);
+        }
+        setParameterReliable(variable.name, variable.reliable);
+        setParameterQuantizer(variable.name, variable.quantizer);
+    }
+    return rebind;
 }
 
-
-void oscVariablesGroup::removeParameter(std::string parameterName){
-    for(auto &node : nodes){
-        node->removeParameter(parameterName);
+void oscVariablesGroup::publishParameters(const std::function<void(std::vector<oscVariable>&)> &edit){
+    std::lock_guard<std::mutex> lock(parameterMutex);
+    auto table = std::make_shared<oscParameterTable>();
+    table->variables = parameterTable->variables;
+    edit(table->variables);
+    for(size_t i = 0; i < table->variables.size(); i++){
+        oscVariable &variable = table->variables[i];
+        table->byName[variable.name] = i;
+        switch(variable.type->lane){
+            case oscPackedLane::Float: variable.packedIndex = table->numPackedFloats++; break;
+            case oscPackedLane::Int: variable.packedIndex = table->numPackedInts++; break;
+            case oscPackedLane::String: variable.packedIndex = table->numPackedStrings++; break;
+            case oscPackedLane::None: variable.packedIndex = -1; break;
+        }
     }
-    parameters.erase(std::remove_if(parameters.begin(), parameters.end(), [parameterName](auto &parameter){return parameter->getName() == parameterName;}), parameters.end());
+    std::atomic_store(&parameterTable, std::shared_ptr<const oscParameterTable>(std::move(table)));
 }
 
 //bool oscVariablesGroup::isMyOSCPortAvailable(int port) {
@@ -192,13 +321,27 @@ void oscVariablesGroup::initializeOSC() {
     resetOSCConnection();
 }
 
+oscEndpoint oscVariablesGroup::getEndpoint() const {
+    bool stream = (transport == OscTransport::Tcp);
+    if (oscMode == OscMode::Sender || oscEndpoint::isUnixAddress(ipParam.get())) {
+        return oscEndpoint::fromHostPort(ipParam.get(), portParam.get(), stream);
+    }
+    // Network receivers listen on every interface
+    return oscEndpoint::fromHostPort("", portParam.get(), stream);
+}
+
 void oscVariablesGroup::resetOSCConnection() {
     // First stop everything
     receiver.stop();
     sender.clear();
     
     if (oscMode == OscMode::Sender) {
-        sender.setup(ipParam, portParam);
+        // Every destination in ipParam shares one socket and one serialization
+        sender.setMulticastOptions(multicastTtl, multicastInterface);
+        sender.setSendBufferSize(sendBufferSize);
+        sender.setSequencing(sequencing);
+        sender.setSnapshots(snapshots);
+        sender.setup(ipParam, portParam, transport == OscTransport::Tcp);
     } else {
         // For receiver mode
         receiver.stop();
@@ -206,123 +349,352 @@ void oscVariablesGroup::resetOSCConnection() {
         // Small delay to ensure port is fully released
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
         
-        // Try to setup the receiver
-        bool setupSuccess = receiver.setup(portParam);
+        // Try to setup the receiver, groups on the same port share its socket
+        // and are told apart by the "/groupName/..." address prefix
+        receiver.setReceiveBufferSize(receiveBufferSize);
+        receiver.setSnapshotRequests(snapshots);
+        bool setupSuccess = receiver.setup(getEndpoint(), name);
         
         if(setupSuccess) {
-            ofLog() << "Successfully set up OSC Receiver on port: " << portParam;
+            ofLog() << "Successfully set up OSC Receiver on: " << getEndpoint().toString();
+            if(!multicastGroups.empty() && !receiver.joinMulticast(multicastGroups, multicastInterface)) {
+                ofLogError() << "Failed to join multicast groups: " << multicastGroups;
+            }
         } else {
-            ofLogError() << "Failed to set up OSC Receiver on port: " << portParam;
+            ofLogError() << "Failed to set up OSC Receiver on: " << getEndpoint().toString();
         }
     }
 }
 
-void oscVariablesGroup::update() {
-    if (oscMode != OscMode::Receiver) return;
+void oscVariablesGroup::sendMessage(const ofxOscMessage &message) {
+    const string &address = message.getAddress();
+    if (monitoredParameters > 0) {
+        recordSample(message);
+    }
+    if (!reliableParameters.empty() && reliableParameters.count(address.substr(1)) != 0) {
+        sender.sendReliableMessage(message);
+    } else if (framed) {
+        // Sent as one frame from update(), a later change of the same variable replaces the earlier one
+        auto index = frameIndices.find(address);
+        if (index != frameIndices.end()) {
+            frameMessages[index->second] = message;
+        } else {
+            frameIndices[address] = frameMessages.size();
+            frameMessages.push_back(message);
+        }
+    } else {
+        sender.sendMessage(message);
+    }
+}
 
-    // Map to store the latest message for each address
-    std::map<string, ofxOscMessage> latestMessages;
+bool oscVariablesGroup::startRecording(const std::string &path) {
+    if (oscMode != OscMode::Receiver || !recorder.start(path)) return false;
+    receiver.setRecorder(&recorder);
+    ofLogNotice("oscVariablesGroup") << "Recording " << name << " to " << path;
+    return true;
+}
+
+void oscVariablesGroup::stopRecording() {
+    receiver.setRecorder(nullptr);
+    recorder.stop();
+}
+
+bool oscVariablesGroup::startPlayback(const std::string &path, float speed, double startSeconds) {
+    if (oscMode != OscMode::Receiver) return false;
+    stopPlayback();
+    // The capture replaces the socket until it ends
+    receiver.stop();
+    if (!player.play(path, receiver, speed, startSeconds)) {
+        resetOSCConnection();
+        return false;
+    }
+    playbackActive = true;
+    return true;
+}
+
+void oscVariablesGroup::stopPlayback() {
+    player.stop();
+    if (playbackActive) {
+        playbackActive = false;
+        resetOSCConnection();
+    }
+}
+
+void oscVariablesGroup::getParameterMessage(const oscVariable &variable, ofxOscMessage &message) const {
+    message.setAddress("/" + variable.parameter->getName());
+    if (variable.quantizer.isEnabled()) {
+        variable.quantizer.encode(static_cast<const ofParameter<std::vector<float>>&>(*variable.parameter).get(), message);
+    } else {
+        variable.type->encode(*variable.parameter, message);
+    }
+}
+
+void oscVariablesGroup::sendParameter(const std::string &parameterName) {
+    auto table = getParameters();
+    auto variable = table->find(parameterName);
+    if (variable == nullptr) return;
+    ofxOscMessage message;
+    getParameterMessage(*variable, message);
+    sendMessage(message);
+}
+
+void oscVariablesGroup::setParameterQuantizer(const std::string &parameterName, const oscQuantizer &quantizer) {
+    auto variable = getParameters()->find(parameterName);
+    if (variable == nullptr) return;
+    if (quantizer.isEnabled() && variable->type != &oscVariableTypeOf<std::vector<float>>()) {
+        ofLogWarning("oscVariablesGroup") << "Only float vectors can be quantized, " << parameterName << " is " << variable->type->name;
+        return;
+    }
+    const oscQuantizer &current = variable->quantizer;
+    if (current.format == quantizer.format && current.min == quantizer.min && current.max == quantizer.max) return;
+    publishParameters([&parameterName, &quantizer](auto &variables){
+        for (auto &variable : variables) {
+            if (variable.name == parameterName) {
+                variable.quantizer = quantizer;
+            }
+        }
+    });
+}
+
+void oscVariablesGroup::setParameterReliable(const std::string &parameterName, bool reliable) {
+    if (reliable) {
+        reliableParameters.insert(parameterName);
+    } else {
+        reliableParameters.erase(parameterName);
+    }
+}
+
+std::string oscVariablesGroup::getValuesPath() const {
+    return ofToDataPath("oscVars." + name + ".values", true);
+}
+
+bool oscVariablesGroup::restoreValues() {
+    std::vector<ofxOscMessage> messages;
+    if(!oscValueStore::load(getValuesPath(), messages)) return false;
+    auto table = getParameters();
+    for(auto &message : messages) {
+        const std::string &address = message.getAddress();
+        auto variable = address.size() > 1 ? table->find(address.substr(1)) : nullptr;
+        if(variable == nullptr) continue;
+        try {
+            variable->type->decode(message, *variable->parameter);
+        }
+        catch (const std::exception& e) {
+            ofLogError("oscVariablesGroup") << "Could not restore " << message.getAddress() << ": " << e.what();
+        }
+    }
+    // Nothing changed since the file was written
+    lastCheckpoint = ofGetElapsedTimeMillis();
+    return true;
+}
+
+void oscVariablesGroup::checkpointValues(bool force) {
+    uint64_t now = ofGetElapsedTimeMillis();
+    if(!force && now - lastCheckpoint < OSC_VALUES_CHECKPOINT_MS) return;
+    lastCheckpoint = now;
+    OSC_TRACE_SCOPE("osc.checkpoint");
     
-    // Collect all waiting messages, keeping only the latest for each address
-    while (receiver.hasWaitingMessages()) {
+    auto table = getParameters();
+    ofxOscBundle bundle;
+    for(auto &variable : table->variables) {
+        // Full precision, quantization is only for the wire
         ofxOscMessage message;
-        receiver.getNextMessage(message);
+        message.setAddress("/" + variable.name);
+        variable.type->encode(*variable.parameter, message);
+        bundle.addMessage(message);
+    }
+    if(!valueWriter.writeBundle(bundle)) {
+        ofLogError("oscVariablesGroup") << "Values of " << name << " do not fit in a checkpoint";
+        return;
+    }
+    valueStore.checkpoint(getValuesPath(), valueWriter.data(), valueWriter.size());
+}
+
+void oscVariablesGroup::setParameterMonitored(const std::string &parameterName, bool monitored) {
+    auto variable = getParameters()->find(parameterName);
+    if (variable == nullptr || (variable->monitor != nullptr) == monitored) return;
+    publishParameters([&parameterName, monitored](auto &variables){
+        for (auto &variable : variables) {
+            if (variable.name == parameterName) {
+                variable.monitor = monitored ? std::make_shared<oscVariableMonitor>() : nullptr;
+            }
+        }
+    });
+    monitoredParameters += monitored ? 1 : -1;
+    // Receivers watch their traffic from the receive thread, only while it is needed
+    if (oscMode == OscMode::Receiver) {
+        if (monitoredParameters > 0) {
+            receiver.setObserver([this](const ofxOscMessage &message){recordSample(message);});
+        } else {
+            receiver.setObserver(nullptr);
+        }
+    }
+}
+
+void oscVariablesGroup::recordSample(const ofxOscMessage &message) {
+    const string &address = message.getAddress();
+    if (address.size() < 2) return;
+    auto table = getParameters();
+    auto variable = table->find(address.substr(1));
+    if (variable != nullptr && variable->monitor != nullptr) {
+        variable->monitor->record(message);
+    }
+}
+
+void oscVariablesGroup::update() {
+    OSC_TRACE_SCOPE("osc.update");
+    if (persistValues) {
+        checkpointValues();
+    }
+    
+    if (oscMode == OscMode::Sender) {
+        if (!frameMessages.empty()) {
+            OSC_TRACE_SCOPE("osc.frame");
+            sender.sendFrame(frameMessages);
+            frameMessages.clear();
+            frameIndices.clear();
+        }
+        
+        // Answer NACKs for reliable variables and flush TCP streams
+        sender.update();
         
-        string msgAddress = message.getAddress();
-        if (!msgAddress.empty() && msgAddress[0] == '/') {
-            msgAddress = msgAddress.substr(1);
+        // Receivers that just started (or came back) ask for everything once
+        if (sender.hasSnapshotRequests()) {
+            OSC_TRACE_SCOPE("osc.snapshot");
+            auto table = getParameters();
+            std::vector<ofxOscMessage> snapshot;
+            snapshot.resize(table->variables.size());
+            for (size_t i = 0; i < table->variables.size(); i++) {
+                getParameterMessage(table->variables[i], snapshot[i]);
+            }
+            sender.sendSnapshot(snapshot);
         }
         
-        // Store or overwrite with the latest message for this address
-        latestMessages[msgAddress] = std::move(message);
+        if (packed) {
+            updatePacked(*getParameters());
+        }
+        return;
     }
+
+    // Map to store the latest message for each address
+    std::map<string, ofxOscMessage> latestMessages;
     
-    // Now process only the latest message for each address
-    std::lock_guard<std::mutex> lock(parameterMutex);
+    // Checked before draining so the tail of a finished capture is still applied
+    bool playbackEnded = playbackActive && !player.isPlaying();
+    
+    auto table = getParameters();
     
-    for (const auto& pair : latestMessages) 
+    // Take everything received so far in one swap, frames arrive whole, and keep only the latest for each address
     {
-        const string& msgAddress = pair.first;
-        const ofxOscMessage& message = pair.second;
-        
-        auto paramIt = std::find_if(parameters.begin(), parameters.end(),
-                                  [&msgAddress](const auto& param) {
-                                      return param->getName() == msgAddress;
-                                  });
-        
-        if (paramIt != parameters.end()) {
-            auto& param = *paramIt;
+        OSC_TRACE_SCOPE("osc.drain");
+        receiver.takeMessages(receivedMessages);
+    }
+    size_t drainedMessages = receivedMessages.size();
+    {
+        OSC_TRACE_SCOPE("osc.coalesce");
+        for (auto &message : receivedMessages) {
+            string msgAddress = message.getAddress();
+            if (!msgAddress.empty() && msgAddress[0] == '/') {
+                msgAddress = msgAddress.substr(1);
+            }
             
-            try {
-                // Handle float parameters
-                if (param->isOfType<float>()) {
-                    if (message.getNumArgs() > 0 && message.getArgType(0) == OFXOSC_TYPE_FLOAT) {
-                        float value = message.getArgAsFloat(0);
-                        param->cast<float>() = value;
-                    }
-                }
-                else if (param->isOfType<int>()) {
-                    if (message.getNumArgs() > 0 && message.getArgType(0) == OFXOSC_TYPE_INT32) {
-                        int value = message.getArgAsInt32(0);
-                        param->cast<int>() = value;
-                    }
-                }
-                // Handle string parameters
-                else if (param->isOfType<string>()) {
-                    if (message.getNumArgs() > 0 && message.getArgType(0) == OFXOSC_TYPE_STRING) {
-                        string value = message.getArgAsString(0);
-                        param->cast<string>() = value;
-                    }
-                }
-                // Handle float vector parameters
-                else if (param->isOfType<vector<float>>()) {
-                    vector<float> values;
-                    for (int i = 0; i < message.getNumArgs(); i++) {
-                        if (message.getArgType(i) == OFXOSC_TYPE_FLOAT) {
-                            values.push_back(message.getArgAsFloat(i));
-                        }
-                    }
-                    if (!values.empty()) {
-                        param->cast<vector<float>>() = values;
-                    }
-                }
-                else if (param->isOfType<vector<int>>()) {
-                    vector<int> values;
-                    for (int i = 0; i < message.getNumArgs(); i++) {
-                        if (message.getArgType(i) == OFXOSC_TYPE_INT32) {
-                            values.push_back(message.getArgAsInt32(i));
-                        }
-                    }
-                    if (!values.empty()) {
-                        param->cast<vector<int>>() = values;
+            // Unknown addresses fall through the lookup below at no extra cost once learning is off
+            if (learning && table->find(msgAddress) == nullptr) {
+                learned.observe(msgAddress, message);
+            }
+            
+            // Store or overwrite with the latest message for this address
+            latestMessages[msgAddress] = std::move(message);
+        }
+    }
+    messagesCoalesced += drainedMessages - latestMessages.size();
+    
+    // Decoding sets the variables, so this includes every listener they notify
+    {
+        OSC_TRACE_SCOPE("osc.decode");
+        // Every value is set before any listener runs, so a listener of one variable
+        // never sees the others of the same frame still holding their old values
+        stagedVariables.clear();
+        for (const auto& pair : latestMessages) 
+        {
+            const string& msgAddress = pair.first;
+            const ofxOscMessage& message = pair.second;
+            
+            auto variable = table->find(msgAddress);
+            
+            if (variable) {
+                
+                try {
+                    // Messages of another numeric type are converted, anything else leaves the variable as it is
+                    if (variable->type->stage(message, *variable->parameter)) {
+                        stagedVariables.push_back(variable);
                     }
                 }
-                // Handle string vector parameters
-                else if (param->isOfType<vector<string>>()) {
-                    vector<string> values;
-                    for (int i = 0; i < message.getNumArgs(); i++) {
-                        if (message.getArgType(i) == OFXOSC_TYPE_STRING) {
-                            values.push_back(message.getArgAsString(i));
-                        }
-                    }
-                    if (!values.empty()) {
-                        param->cast<vector<string>>() = values;
-                    }
+                catch (const std::exception& e) {
+                    ofLogError("oscVariablesGroup") << "Error processing message for parameter "
+                        << msgAddress << ": " << e.what();
                 }
             }
+        }
+        for (auto variable : stagedVariables) {
+            try {
+                variable->type->notify(*variable->parameter);
+            }
             catch (const std::exception& e) {
                 ofLogError("oscVariablesGroup") << "Error processing message for parameter "
-                    << msgAddress << ": " << e.what();
+                    << variable->parameter->getName() << ": " << e.what();
             }
         }
     }
+    
+    if (packed) {
+        updatePacked(*table);
+    }
+    
+    if (playbackEnded) {
+        stopPlayback();
+    }
 }
 //-------------------------------------------------------------------------
 // ofxOceanodeOSCVariablesController
 //-------------------------------------------------------------------------
 
 ofxOceanodeOSCVariablesController::ofxOceanodeOSCVariablesController(shared_ptr<ofxOceanodeContainer> _container) : container(_container), ofxOceanodeBaseController("OSC Variables"){
+    oscTrace::setThreadName("main");
     load();
+    updateListener = ofEvents().update.newListener([this](ofEventArgs &){
+        oscTrace::mark("frame");
+        if(watcher.changed()) {
+            ofLogNotice("ofxOceanodeOSCVariablesController") << "oscVars.json changed, reloading";
+            load();
+        }
+        // Once per group and frame, after the nodes made their changes, whether
+        // or not the group has nodes: NACKs, snapshots and heartbeats depend on it
+        for(auto &group : groups) {
+            group->update();
+        }
+    }, OF_EVENT_ORDER_AFTER_APP);
+}
+
+void ofxOceanodeOSCVariablesController::setWatching(bool watching) {
+    if(watching == watcher.isWatching()) return;
+    if(watching) {
+        watcher.start(ofToDataPath("oscVars.json", true));
+    } else {
+        watcher.stop();
+    }
+}
+
+void ofxOceanodeOSCVariablesController::removeGroup(std::shared_ptr<oscVariablesGroup> group) {
+    string modName = (group->oscMode == OscMode::Sender) ? "Sender " : "Receiv. ";
+    container->getRegistry()->unregisterModel<oscVariables>("OSC Variables", modName + group->name, std::weak_ptr<oscVariablesGroup>());
+    
+    // Remove all existing nodes of this type
+    for(auto* node : group->nodes) {
+        node->deleteSelf();
+    }
+    
+    groups.erase(std::remove(groups.begin(), groups.end(), group), groups.end());
 }
 
 ofxOceanodeOSCVariablesController::~ofxOceanodeOSCVariablesController() {
@@ -352,7 +724,9 @@ ofxOceanodeOSCVariablesController::~ofxOceanodeOSCVariablesController() {
 void ofxOceanodeOSCVariablesController::draw() {
     string groupToDelete = "";
     for(auto &group : groups) {
-        auto &groupParams = group->parameters;
+        // Held for the whole frame, removing a variable below does not pull it from under the loop
+        auto parameterTable = group->getParameters();
+        auto &groupParams = parameterTable->variables;
         ImGui::PushID(group->name.c_str());
         if(groups.size()>1) ImGui::SetNextItemOpen(false, ImGuiCond_Once);
 		else ImGui::SetNextItemOpen(true, ImGuiCond_Once);
@@ -386,41 +760,41 @@ void ofxOceanodeOSCVariablesController::draw() {
                 bool isListening = group->sender.isReady();
                 ImGui::Checkbox("Is ready?", &isListening);
                 ImGui::SameLine();
-                ImGui::Text("Port:");
-                ImGui::SameLine();
-                ImGui::SetNextItemWidth(100);
                 
-                // Create unique identifier for each port input
-                string portInputId = "##senderport_" + group->name;
-                static std::map<string, int> tempPorts;  // Store temp ports per group
-                
-                // Initialize temp port if needed
-                if(tempPorts.find(group->name) == tempPorts.end()) {
-                    tempPorts[group->name] = group->portParam;
-                }
-                
-                if (ImGui::InputInt(portInputId.c_str(), &tempPorts[group->name], 0, 0, ImGuiInputTextFlags_EnterReturnsTrue)) {
-                    if (tempPorts[group->name] != group->portParam) {
-                        group->portParam = ofClamp(tempPorts[group->name], 1024, 65535);
-                        configChanged = true;
+                // Unix socket destinations have no port
+                if (!oscEndpoint::isUnixAddress(group->ipParam.get())) {
+                    ImGui::Text("Port:");
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    
+                    static std::map<string, int> tempPorts;  // Store temp ports per group
+                    
+                    // Initialize temp port if needed
+                    if(tempPorts.find(group->name) == tempPorts.end()) {
+                        tempPorts[group->name] = group->portParam;
+                    }
+                    
+                    if (ImGui::InputInt("##senderport", &tempPorts[group->name], 0, 0, ImGuiInputTextFlags_EnterReturnsTrue)) {
+                        if (tempPorts[group->name] != group->portParam) {
+                            group->portParam = ofClamp(tempPorts[group->name], 1024, 65535);
+                            configChanged = true;
+                        }
                     }
+                    ImGui::SameLine();
                 }
-                ImGui::SameLine();
-                // IP Address for Sender
+                // IP Address, unix:/path or comma separated destination list for Sender
                 ImGui::Text("IP Address:");
                 ImGui::SameLine();
-                ImGui::SetNextItemWidth(120);
+                ImGui::SetNextItemWidth(220);
                 
-                // Create unique identifier for IP input
-                string ipInputId = "##ip_" + group->name;
-                static std::map<string, char[16]> ipBuffers;  // Store IP buffers per group
+                static std::map<string, char[256]> ipBuffers;  // Store IP buffers per group
                 
                 // Initialize IP buffer if needed
                 if(ipBuffers.find(group->name) == ipBuffers.end()) {
-                    strcpy(ipBuffers[group->name], group->ipParam.get().c_str());
+                    strncpy(ipBuffers[group->name], group->ipParam.get().c_str(), 255);
                 }
                 
-                if (ImGui::InputText(ipInputId.c_str(), ipBuffers[group->name], 16,
+                if (ImGui::InputText("##ip", ipBuffers[group->name], 256,
                                      ImGuiInputTextFlags_EnterReturnsTrue))
                 {
                     string newIp = string(ipBuffers[group->name]);
@@ -430,6 +804,39 @@ void ofxOceanodeOSCVariablesController::draw() {
                         configChanged = true;
                     }
                 }
+                
+                if (group->sender.getEndpoints().size() > 1) {
+                    ImGui::Text("Destinations: %d", (int)group->sender.getEndpoints().size());
+                }
+                if (group->sender.getNumStreams() > 0) {
+                    ImGui::Text("TCP connected: %d / %d", (int)group->sender.getNumConnectedStreams(), (int)group->sender.getNumStreams());
+                }
+                
+                // Multicast options only make sense with a multicast destination
+                if (group->sender.hasMulticastDestinations()) {
+                    ImGui::Text("Multicast TTL:");
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(80);
+                    int ttl = group->multicastTtl;
+                    if (ImGui::InputInt("##multicastttl", &ttl, 1, 1, ImGuiInputTextFlags_EnterReturnsTrue)) {
+                        group->multicastTtl = ofClamp(ttl, 0, 255);
+                        configChanged = true;
+                    }
+                    ImGui::SameLine();
+                    ImGui::Text("Interface:");
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(120);
+                    static std::map<string, char[16]> interfaceBuffers;
+                    if(interfaceBuffers.find(group->name) == interfaceBuffers.end()) {
+                        strncpy(interfaceBuffers[group->name], group->multicastInterface.c_str(), 15);
+                    }
+                    if (ImGui::InputTextWithHint("##multicastif", "default", interfaceBuffers[group->name], 16,
+                                                 ImGuiInputTextFlags_EnterReturnsTrue))
+                    {
+                        group->multicastInterface = string(interfaceBuffers[group->name]);
+                        configChanged = true;
+                    }
+                }
             }
             else
             {
@@ -437,14 +844,168 @@ void ofxOceanodeOSCVariablesController::draw() {
                 bool isListening = group->receiver.isListening();
                 ImGui::Checkbox("Is listening?", &isListening);
                 ImGui::SameLine();
-                ImGui::Text("Port:");
+                if (!oscEndpoint::isUnixAddress(group->ipParam.get())) {
+                    ImGui::Text("Port:");
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    int tempPort = group->portParam.get();
+                    configChanged = ImGui::InputInt("##receiverport", &tempPort,1,1,ImGuiInputTextFlags_EnterReturnsTrue);
+                    
+                    tempPort = ofClamp(tempPort, 1024, 65535);
+                    group->portParam.set(tempPort);
+                    ImGui::SameLine();
+                }
+                if (group->transport == OscTransport::Tcp && !oscEndpoint::isUnixAddress(group->ipParam.get())) {
+                    ImGui::Text("TCP clients: %d", (int)group->receiver.getNumClients());
+                    ImGui::SameLine();
+                } else if (!oscEndpoint::isUnixAddress(group->ipParam.get())) {
+                    // Multicast groups to join on this port
+                    ImGui::Text("Join:");
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(140);
+                    static std::map<string, char[256]> joinBuffers;
+                    if(joinBuffers.find(group->name) == joinBuffers.end()) {
+                        strncpy(joinBuffers[group->name], group->multicastGroups.c_str(), 255);
+                    }
+                    if (ImGui::InputTextWithHint("##receiverjoin", "multicast groups", joinBuffers[group->name], 256,
+                                                 ImGuiInputTextFlags_EnterReturnsTrue))
+                    {
+                        group->multicastGroups = string(joinBuffers[group->name]);
+                        configChanged = true;
+                    }
+                    ImGui::SameLine();
+                }
+                
+                // Optional unix:/path to listen on a local socket instead of the UDP port
+                ImGui::Text("Socket:");
                 ImGui::SameLine();
+                ImGui::SetNextItemWidth(160);
+                static std::map<string, char[256]> socketBuffers;
+                if(socketBuffers.find(group->name) == socketBuffers.end()) {
+                    string current = oscEndpoint::isUnixAddress(group->ipParam.get()) ? group->ipParam.get() : "";
+                    strncpy(socketBuffers[group->name], current.c_str(), 255);
+                }
+                if (ImGui::InputTextWithHint("##receiversocket", "unix:/path", socketBuffers[group->name], 256,
+                                             ImGuiInputTextFlags_EnterReturnsTrue))
+                {
+                    string newSocket = string(socketBuffers[group->name]);
+                    if (newSocket != group->ipParam.get())
+                    {
+                        group->ipParam = newSocket;
+                        configChanged = true;
+                    }
+                }
+            }
+            
+            // Socket buffers and drop counters, to tell kernel overflow apart from coalescing
+            if (ImGui::TreeNode("Socket")) {
+                bool isSender = (group->oscMode == OscMode::Sender);
+                int &bufferSize = isSender ? group->sendBufferSize : group->receiveBufferSize;
+                int bufferKB = bufferSize / 1024;
                 ImGui::SetNextItemWidth(100);
-                int tempPort = group->portParam.get();
-                configChanged = ImGui::InputInt(ofToString("##receiverport"+group->name).c_str(), &tempPort,1,1,ImGuiInputTextFlags_EnterReturnsTrue);
+                if (ImGui::InputInt(isSender ? "Send Buffer (KB)" : "Receive Buffer (KB)", &bufferKB, 64, 1024, ImGuiInputTextFlags_EnterReturnsTrue)) {
+                    bufferSize = std::max(bufferKB, 0) * 1024;
+                    if (isSender) group->sender.setSendBufferSize(bufferSize);
+                    else group->receiver.setReceiveBufferSize(bufferSize);
+                }
                 
-                tempPort = ofClamp(tempPort, 1024, 65535);
-                group->portParam.set(tempPort);
+                oscSocketStats stats = isSender ? group->sender.getStats() : group->receiver.getStats();
+                ImGui::Text("Kernel buffer: %d KB", stats.bufferSize / 1024);
+                if (isSender) {
+                    ImGui::Text("Packets sent: %llu", (unsigned long long)stats.packets);
+                    ImGui::Text("Send errors: %llu", (unsigned long long)stats.errors);
+                    if (stats.sendDrops > 0) {
+                        ImGui::Text("Dropped, socket full: %llu", (unsigned long long)stats.sendDrops);
+                    }
+                    if (ImGui::Checkbox("Sequence numbers", &group->sequencing)) {
+                        group->sender.setSequencing(group->sequencing);
+                    }
+                    if (ImGui::Checkbox("Answer snapshots", &group->snapshots)) {
+                        group->sender.setSnapshots(group->snapshots);
+                    }
+                    // Receivers apply all changes of a frame together
+                    ImGui::Checkbox("Framed", &group->framed);
+                    ImGui::Text("Snapshots sent: %llu", (unsigned long long)group->sender.getSnapshotsSent());
+                } else {
+                    ImGui::Text("Packets received: %llu", (unsigned long long)stats.packets);
+                    if (stats.kernelDrops >= 0) {
+                        ImGui::Text("Kernel drops: %lld", (long long)stats.kernelDrops);
+                    } else {
+                        ImGui::TextDisabled("Kernel drops: not available");
+                    }
+                    ImGui::Text("Malformed: %llu", (unsigned long long)stats.errors);
+                    ImGui::Text("Coalesced: %llu", (unsigned long long)group->messagesCoalesced);
+                    if (ImGui::Checkbox("Request snapshots", &group->snapshots)) {
+                        group->receiver.setSnapshotRequests(group->snapshots);
+                    }
+                    ImGui::Text("Snapshots requested: %llu", (unsigned long long)group->receiver.getSnapshotsRequested());
+                    
+                    oscFrameStats frameStats = group->receiver.getFrameStats();
+                    if (frameStats.committed + frameStats.incomplete > 0) {
+                        ImGui::Text("Frames: %llu", (unsigned long long)frameStats.committed);
+                        ImGui::Text("Incomplete frames: %llu", (unsigned long long)frameStats.incomplete);
+                    }
+                    
+                    oscSequenceStats sequenceStats = group->receiver.getSequenceStats();
+                    if (sequenceStats.packets > 0) {
+                        ImGui::Text("Sequenced packets: %llu", (unsigned long long)sequenceStats.packets);
+                        ImGui::Text("Lost: %llu (%.2f%%)", (unsigned long long)sequenceStats.lost, sequenceStats.lossRate() * 100);
+                        ImGui::Text("Late: %llu (%.2f%%)", (unsigned long long)sequenceStats.reordered, sequenceStats.reorderRate() * 100);
+                        ImGui::Text("Duplicates: %llu", (unsigned long long)sequenceStats.duplicates);
+                    }
+                    
+                    oscReliableStats reliableStats = group->receiver.getReliableStats();
+                    if (reliableStats.nacksSent > 0) {
+                        ImGui::Text("NACKs sent: %llu", (unsigned long long)reliableStats.nacksSent);
+                        ImGui::Text("Recovered: %llu", (unsigned long long)reliableStats.recovered);
+                        ImGui::Text("Unrecoverable: %llu", (unsigned long long)reliableStats.unrecoverable);
+                    }
+                }
+                ImGui::TreePop();
+            }
+            
+            // Capture of the raw receiver traffic, and replay without the socket
+            if (group->oscMode == OscMode::Receiver && ImGui::TreeNode("Capture")) {
+                static std::map<string, char[256]> captureBuffers;
+                static std::map<string, float> playbackSpeeds;
+                static std::map<string, float> playbackStarts;
+                if(captureBuffers.find(group->name) == captureBuffers.end()) {
+                    strncpy(captureBuffers[group->name], ofToDataPath(group->name + ".osccap").c_str(), 255);
+                    playbackSpeeds[group->name] = 1;
+                    playbackStarts[group->name] = 0;
+                }
+                ImGui::SetNextItemWidth(260);
+                ImGui::InputText("File", captureBuffers[group->name], 256);
+                string capturePath = string(captureBuffers[group->name]);
+                
+                if (group->recorder.isRecording()) {
+                    if (ImGui::Button("Stop recording")) group->stopRecording();
+                    ImGui::SameLine();
+                    ImGui::Text("%llu packets, %.1f MB", (unsigned long long)group->recorder.getPackets(), group->recorder.getBytes() / (1024.0f * 1024.0f));
+                } else if (ImGui::Button("Record")) {
+                    group->startRecording(capturePath);
+                }
+                
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputFloat("Speed (0 = max)", &playbackSpeeds[group->name], 0.5f, 1.0f, "%.2f");
+                playbackSpeeds[group->name] = std::max(playbackSpeeds[group->name], 0.0f);
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputFloat("Start at (s)", &playbackStarts[group->name], 1.0f, 10.0f, "%.1f");
+                playbackStarts[group->name] = std::max(playbackStarts[group->name], 0.0f);
+                if (group->player.isPlaying()) {
+                    if (ImGui::Button("Stop playback")) group->stopPlayback();
+                    ImGui::SameLine();
+                    ImGui::ProgressBar(group->player.getProgress(), ImVec2(160, 0));
+                } else if (ImGui::Button("Play")) {
+                    group->startPlayback(capturePath, playbackSpeeds[group->name], playbackStarts[group->name]);
+                }
+                if (group->player.getDuration() > 0) {
+                    ImGui::Text("Duration: %.1f s, seek took %.2f ms", group->player.getDuration(), group->player.getSeekMilliseconds());
+                }
+                if (group->player.getPacketsPerSecond() > 0) {
+                    ImGui::Text("Last run: %.0f packets/s, %.1f MB/s", group->player.getPacketsPerSecond(), group->player.getBytesPerSecond() / (1024.0 * 1024.0));
+                }
+                ImGui::TreePop();
             }
             
             // If any config parameter changed, reset the OSC connection
@@ -458,69 +1019,207 @@ void ofxOceanodeOSCVariablesController::draw() {
             //-------------------------------------------------
             // Group parameters
             //-------------------------------------------------
-            for(int i = 0; i < groupParams.size(); i++)
+            // Rows matching the filter, rebuilt only when the table or the filter change
+            struct VariableRows {
+                std::shared_ptr<const oscParameterTable> table;
+                std::string filter;
+                std::vector<int> rows;
+                std::vector<int> monitored;
+            };
+            static std::map<string, VariableRows> variableRows;
+            static std::map<string, char[64]> filterBuffers;
+            ImGui::SetNextItemWidth(200);
+            ImGui::InputTextWithHint("##filter", "filter", filterBuffers[group->name], 64);
+            VariableRows &visible = variableRows[group->name];
+            if(visible.table != parameterTable || visible.filter != filterBuffers[group->name]) {
+                visible.table = parameterTable;
+                visible.filter = filterBuffers[group->name];
+                std::string key = ofToLower(visible.filter);
+                visible.rows.clear();
+                visible.monitored.clear();
+                for(int i = 0; i < groupParams.size(); i++) {
+                    if(key.empty() || groupParams[i].searchKey.find(key) != std::string::npos) {
+                        visible.rows.push_back(i);
+                    }
+                    if(groupParams[i].monitor != nullptr) {
+                        visible.monitored.push_back(i);
+                    }
+                }
+            }
+            if(visible.rows.size() != groupParams.size()) {
+                ImGui::SameLine();
+                ImGui::Text("%d / %d", (int)visible.rows.size(), (int)groupParams.size());
+            }
+            
+            // Only the rows on screen are laid out, every row is one frame high
+            ImGuiListClipper clipper;
+            clipper.Begin(visible.rows.size(), ImGui::GetFrameHeightWithSpacing());
+            while(clipper.Step())
+            for(int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
             {
-                ofAbstractParameter &absParam = *groupParams[i];
-                std::string uniqueId = absParam.getName();
+                const oscVariable &variable = groupParams[visible.rows[row]];
+                const std::string &uniqueId = variable.name;
                 ImGui::PushID(uniqueId.c_str());
                 
+                ImGui::AlignTextToFramePadding();
                 ImGui::Text("/");
                 ImGui::SameLine();
                 
                 // Get current cursor position
-                ImVec2 cursorPos = ImGui::GetCursorPos();
-                ImVec2 windowPos = ImGui::GetWindowPos();
-                
+                ImVec2 cursorPos = ImGui::GetCursorScreenPos();
                 
                 // Calculate rectangle dimensions
-                float rectHeight = ImGui::GetTextLineHeight() + 4;  // Add some padding
+                float rectHeight = ImGui::GetFrameHeight();
                 
                 // Draw the background rectangle (spans full width to 200)
                 ImGui::GetWindowDrawList()->AddRectFilled(
-                                                          ImVec2(windowPos.x + cursorPos.x, windowPos.y + cursorPos.y),
-                                                          ImVec2(windowPos.x + cursorPos.x + 200, windowPos.y + cursorPos.y + rectHeight),
+                                                          cursorPos,
+                                                          ImVec2(cursorPos.x + 200, cursorPos.y + rectHeight),
                                                           IM_COL32(64, 64, 64, 255)  // Mid gray (adjust color as needed)
                                                           );
                 
                 // Draw the text
-                ImGui::Text("%s", uniqueId.c_str());
+                ImGui::TextUnformatted(uniqueId.c_str());
                 ImGui::SameLine(225);
                 ImGui::SetNextItemWidth(100);
                 
-                std::string hiddenUniqueId = "##" + uniqueId;
-                if(absParam.isOfType<float>())
-                {
-                    ImGui::Text("Float");
-                }
-                else if(absParam.isOfType<string>())
-                {
-                    ImGui::Text("String");
-                    
-                }
-                else if(absParam.isOfType<vector<float>>()) {
-                    ImGui::Text("Vec.Float");
-                }
-                else if(absParam.isOfType<vector<string>>()) {
-                    ImGui::Text("Vec.String");
+                ImGui::TextUnformatted(variable.type->tag);
+                
+                ImGui::SameLine(225 + 80);
+                if(ImGui::Button("[-]")){
+                    group->removeParameter(uniqueId);
                 }
-                else if(absParam.isOfType<int>()) {
-                    ImGui::Text("Int");
+                
+                if(group->packed && variable.packedIndex >= 0) {
+                    ImGui::SameLine();
+                    ImGui::Text("[%d]", variable.packedIndex);
                 }
-                else if(absParam.isOfType<vector<int>>()) {
-                    ImGui::Text("Vec.Int");
+                
+                ImGui::SameLine();
+                bool monitored = variable.monitor != nullptr;
+                if(ImGui::Checkbox("Monitor", &monitored)) {
+                    group->setParameterMonitored(uniqueId, monitored);
                 }
                 
-                ImGui::SameLine(225 + 80);
-                if(ImGui::Button("[-]")){
-                    group->removeParameter(absParam.getName());
+                if(group->oscMode == OscMode::Sender) {
+                    ImGui::SameLine();
+                    bool reliable = group->isParameterReliable(uniqueId);
+                    if(ImGui::Checkbox("Reliable", &reliable)) {
+                        group->setParameterReliable(uniqueId, reliable);
+                    }
+                    
+                    // Wire format of float vectors, receivers read any of them
+                    if(variable.type == &oscVariableTypeOf<std::vector<float>>()) {
+                        static const char *formats[] = {"none", "uint8", "uint16", "int16"};
+                        oscQuantizer quantizer = variable.quantizer;
+                        int format = int(quantizer.format);
+                        ImGui::SameLine();
+                        ImGui::SetNextItemWidth(80);
+                        bool changed = ImGui::Combo("##quantize", &format, formats, IM_ARRAYSIZE(formats));
+                        if(quantizer.isEnabled()) {
+                            ImGui::SameLine();
+                            ImGui::SetNextItemWidth(120);
+                            changed |= ImGui::DragFloatRange2("##quantizerange", &quantizer.min, &quantizer.max, 0.01f);
+                        }
+                        if(changed) {
+                            quantizer.format = oscQuantization(format);
+                            group->setParameterQuantizer(uniqueId, quantizer);
+                        }
+                    }
                 }
                 
                 ImGui::PopID();
             }
+            clipper.End();
+            
+            // History of monitored variables, values over time and how far apart messages arrive
+            if(!visible.monitored.empty() && ImGui::TreeNode("Monitor", "Monitor (%d)", (int)visible.monitored.size())) {
+                static std::vector<oscVariableMonitor::Sample> samples;
+                static std::vector<float> values;
+                for(int index : visible.monitored) {
+                    const oscVariable &variable = groupParams[index];
+                    variable.monitor->getSamples(samples);
+                    auto summary = oscVariableMonitor::summarize(samples);
+                    ImGui::PushID(variable.name.c_str());
+                    ImGui::Text("/%s  %llu msgs  %.1f Hz  interval %.2f ms  jitter %.2f ms", variable.name.c_str(),
+                                (unsigned long long)variable.monitor->getCount(), summary.rate, summary.meanInterval, summary.jitter);
+                    if(samples.empty()) {
+                        ImGui::PopID();
+                        continue;
+                    }
+                    const auto &last = samples.back();
+                    if(last.size > 1) {
+                        ImGui::Text("last: mean %.3f min %.3f max %.3f (%u)  window: min %.3f max %.3f", last.mean, last.min, last.max, last.size, summary.min, summary.max);
+                    } else {
+                        ImGui::Text("last: %.3f  window: min %.3f max %.3f", last.mean, summary.min, summary.max);
+                    }
+                    
+                    values.resize(samples.size());
+                    for(size_t i = 0; i < samples.size(); i++) {
+                        values[i] = samples[i].mean;
+                    }
+                    ImGui::PlotLines("##values", values.data(), values.size(), 0, "value", summary.min, summary.max, ImVec2(300, 40));
+                    
+                    // Inter-arrival times in 32 bins from 0 to the longest
+                    if(samples.size() > 1) {
+                        float longest = 0;
+                        for(size_t i = 1; i < samples.size(); i++) {
+                            longest = std::max(longest, (samples[i].time - samples[i - 1].time) / 1000.0f);
+                        }
+                        values.assign(32, 0);
+                        for(size_t i = 1; i < samples.size() && longest > 0; i++) {
+                            float interval = (samples[i].time - samples[i - 1].time) / 1000.0f;
+                            values[std::min<size_t>(interval / longest * 32, 31)]++;
+                        }
+                        ImGui::SameLine();
+                        string overlay = "0 - " + ofToString(longest, 1) + " ms";
+                        ImGui::PlotHistogram("##intervals", values.data(), values.size(), 0, overlay.c_str(), 0, FLT_MAX, ImVec2(200, 40));
+                    }
+                    ImGui::PopID();
+                }
+                ImGui::TreePop();
+            }
             
             if(ImGui::Button("[+]")){
                 ImGui::OpenPopup("New Variable");
             }
+            ImGui::SameLine();
+            // Float, int and string variables also as one vector output each, [i] is the position
+            bool packed = group->packed;
+            if(ImGui::Checkbox("Packed outputs", &packed)){
+                group->setPacked(packed);
+            }
+            ImGui::SameLine();
+            // Values are checkpointed to oscVars.<group>.values and restored on load
+            ImGui::Checkbox("Persist values", &group->persistValues);
+            
+            // Unknown addresses are collected while learning and created as variables in one go
+            if(group->oscMode == OscMode::Receiver) {
+                ImGui::SameLine();
+                ImGui::Checkbox("Learn", &group->learning);
+                if(group->learned.size() > 0 && ImGui::TreeNode("Learned", "Learned (%zu)", group->learned.size())) {
+                    if(ImGui::Button("Create all")) {
+                        size_t created = group->createLearnedVariables();
+                        ofLogNotice("ofxOceanodeOSCVariablesController") << "Created " << created << " variables in " << group->name;
+                    }
+                    ImGui::SameLine();
+                    if(ImGui::Button("Clear")) {
+                        group->learned.clear();
+                    }
+                    if(group->learned.getDropped() > 0) {
+                        ImGui::Text("Not kept (table full): %llu", (unsigned long long)group->learned.getDropped());
+                    }
+                    for(auto &entry : group->learned.getEntries()) {
+                        auto type = oscVariableTypes::infer(entry.typeTags, entry.maxArgs, entry.mixed);
+                        ImGui::Text("/%s ,%s%s", entry.address.c_str(), entry.typeTags.c_str(), entry.mixed ? " (mixed)" : "");
+                        ImGui::SameLine(225);
+                        ImGui::Text("%s", type ? type->tag : "-");
+                        ImGui::SameLine(225 + 80);
+                        ImGui::Text("%llu", (unsigned long long)entry.count);
+                    }
+                    ImGui::TreePop();
+                }
+            }
             
             // Always center this window when appearing
             ImVec2 center = ImGui::GetMainViewport()->GetCenter();
@@ -530,27 +1229,9 @@ void ofxOceanodeOSCVariablesController::draw() {
                 //ImGui::Text("%s %s %s", "New variable for", group->name.c_str(), "group");
                 ImGui::Separator();
                 
-                enum Types {
-                    Type_Float,
-                    Type_FloatVector,
-                    Type_Int,
-                    Type_IntVector,
-                    Type_String,
-                    Type_StringVector,
-                    Type_COUNT
-                };
-                
-                static int type = Type_Float;
-                const char* types_names[Type_COUNT] = {
-                    "Float",
-                    "Float Vector",
-                    "Int",           // Add these
-                    "Int Vector",    // Add these
-                    "String",
-                    "String Vector"
-                };
-                const char* type_name = (type >= 0 && type < Type_COUNT) ? types_names[type] : "Unknown";
-                ImGui::SliderInt("Type", &type, 0, Type_COUNT - 1, type_name);
+                const auto &types = oscVariableTypes::all();
+                static int type = 0;
+                ImGui::SliderInt("Type", &type, 0, types.size() - 1, types[type]->label);
                 
                 static char cString[255];
                 bool enterPressed = false;
@@ -562,43 +1243,8 @@ void ofxOceanodeOSCVariablesController::draw() {
                 
                 if (ImGui::Button("OK", ImVec2(120, 0)) || enterPressed) {
                     string proposedNewName(cString);
-                    if(proposedNewName != "" && find_if(groupParams.begin(), groupParams.end(),
-                                                        [proposedNewName](const auto &param){return param->getName() == proposedNewName;}) == groupParams.end()) {
-                        
-                        switch(type) {
-                            case Type_Float:
-                                group->addFloatParameter(proposedNewName);
-                                break;
-                            case Type_String:
-                                group->addStringParameter(proposedNewName);
-                                break;
-                            case Type_FloatVector:
-                            {
-                                std::vector<float> defaultVec = {0};  // Single element vector with default value
-                                group->addFloatVectorParameter(proposedNewName, defaultVec);
-                                break;
-                            }
-                            case Type_StringVector: 
-                            {
-                                // Initialize with empty vector
-                                std::vector<string> defaultVec;
-                                group->addStringVectorParameter(proposedNewName, defaultVec);
-                                break;
-                            }
-                            case Type_Int:
-                            {
-                                group->addIntParameter(proposedNewName);
-                                break;
-                            }
-                            case Type_IntVector:
-                            {
-                                std::vector<int> defaultVec = {0};
-                                group->addIntVectorParameter(proposedNewName, defaultVec);
-                                break;
-                            }
-                            default:
-                                ofLog() << "Cannot create variable of unknown type";
-                        }
+                    if(proposedNewName != "" && parameterTable->find(proposedNewName) == nullptr) {
+                        group->addParameter(proposedNewName, *types[type]);
                         
                         ImGui::CloseCurrentPopup();
                     }
@@ -635,29 +1281,7 @@ void ofxOceanodeOSCVariablesController::draw() {
         });
         
         if(groupIt != groups.end()) {
-            // Get pointer to the group before removing it
-            auto group = *groupIt;
-            
-            // First unregister the node type from the registry
-            string modName;
-            if(group->oscMode==OscMode::Sender)
-            {
-                modName = "Sender ";
-            }
-            else
-            {
-                modName = "Receiv. ";
-            }
-            
-            container->getRegistry()->unregisterModel<oscVariables>("OSC Variables", modName + group->name, std::weak_ptr<oscVariablesGroup>());
-            
-            // Remove all existing nodes of this type
-            for(auto* node : group->nodes) {
-                node->deleteSelf();
-            }
-            
-            // Now remove the group from our list
-            groups.erase(groupIt);
+            removeGroup(*groupIt);
             
             ofLogNotice("ofxOceanodeOSCVariablesController")
             << "Removed group and unregistered node type: " << groupToDelete;
@@ -677,6 +1301,26 @@ void ofxOceanodeOSCVariablesController::draw() {
     if(ImGui::Button("[Load]")){
         load();
     }
+    ImGui::SameLine();
+    // Reload on every change of oscVars.json, live groups are only touched where they differ
+    bool watching = watcher.isWatching();
+    if(ImGui::Checkbox("Watch file", &watching)){
+        setWatching(watching);
+    }
+    
+    // Send and receive timeline for chrome://tracing or ui.perfetto.dev, see oscTrace.h
+    bool tracing = oscTrace::isEnabled();
+    if(ImGui::Checkbox("Trace", &tracing)){
+        oscTrace::setEnabled(tracing);
+    }
+    ImGui::SameLine();
+    if(ImGui::Button("[Dump trace]")){
+        oscTrace::dump(ofToDataPath("oscTrace.json", true));
+    }
+    ImGui::SameLine();
+    if(ImGui::Button("[Clear trace]")){
+        oscTrace::clear();
+    }
     
     bool unusedOpen = true;
     // Always center this window when appearing
@@ -690,9 +1334,10 @@ void ofxOceanodeOSCVariablesController::draw() {
         
         // Group Name Input
         static char groupNameBuffer[255] = "";
-        static char ipAddressBuffer[16] = "127.0.0.1";
+        static char ipAddressBuffer[256] = "127.0.0.1";
         static int auxPort = 8000;    // Default sender port
         static int oscMode = 0;        // 0 for sender, 1 for receiver
+        static int transport = 0;      // 0 for UDP, 1 for TCP
         
         ImGui::Text("Group Name:");
         bool enterPressed = ImGui::InputText("##groupname", groupNameBuffer, 255,
@@ -700,9 +1345,21 @@ void ofxOceanodeOSCVariablesController::draw() {
         
         // OSC Mode Selection
         ImGui::Separator();
-        ImGui::RadioButton("Sender", &oscMode, 0);
+        if (ImGui::RadioButton("Sender", &oscMode, 0) && strlen(ipAddressBuffer) == 0) {
+            strcpy(ipAddressBuffer, "127.0.0.1");
+        }
         ImGui::SameLine();
-        ImGui::RadioButton("Receiver", &oscMode, 1);
+        if (ImGui::RadioButton("Receiver", &oscMode, 1) && !oscEndpoint::isUnixAddress(ipAddressBuffer)) {
+            memset(ipAddressBuffer, 0, sizeof(ipAddressBuffer));
+        }
+        
+        // Transport Selection
+        ImGui::RadioButton("UDP", &transport, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("TCP", &transport, 1);
+        if (transport == 1) {
+            ImGui::TextDisabled("SLIP framed stream, for big vectors or when nothing may be lost");
+        }
         
         // Show appropriate port based on mode
         if (oscMode == 0) { // Sender mode
@@ -715,17 +1372,23 @@ void ofxOceanodeOSCVariablesController::draw() {
             // IP Address input
             ImGui::Text("Destination IP:");
             ImGui::SameLine(150);
-            ImGui::InputText("##ipaddress", ipAddressBuffer, 16);
+            ImGui::InputText("##ipaddress", ipAddressBuffer, 256);
             ImGui::SameLine();
             if (ImGui::Button("localhost")) {
                 strcpy(ipAddressBuffer, "127.0.0.1");
             }
+            ImGui::TextDisabled("Use unix:/path/to/socket for a local socket,");
+            ImGui::TextDisabled("or a comma separated list (host, host:port, ...) to fan out");
         } else { // Receiver mode
             ImGui::Text("Receiver Port:");
             ImGui::SameLine(150);
             ImGui::SetNextItemWidth(100);
             ImGui::InputInt("##receiverport", &auxPort);
             auxPort = ofClamp(auxPort, 1024, 65535);
+            
+            ImGui::Text("Local Socket:");
+            ImGui::SameLine(150);
+            ImGui::InputTextWithHint("##receiversocket", "unix:/path (optional)", ipAddressBuffer, 256);
         }
         
         ImGui::Separator();
@@ -746,6 +1409,7 @@ void ofxOceanodeOSCVariablesController::draw() {
                 newGroup->name = newName;
                 newGroup->container = container;
                 newGroup->oscMode = (oscMode == 0) ? OscMode::Sender : OscMode::Receiver;
+                newGroup->transport = (transport == 0) ? OscTransport::Udp : OscTransport::Tcp;
                 newGroup->portParam = auxPort;
                 newGroup->ipParam = string(ipAddressBuffer);
                 
@@ -763,6 +1427,7 @@ void ofxOceanodeOSCVariablesController::draw() {
                 strcpy(ipAddressBuffer, "127.0.0.1");
                 auxPort = 8000;
                 oscMode = 0;
+                transport = 0;
                 
                 ImGui::CloseCurrentPopup();
             }
@@ -777,6 +1442,7 @@ void ofxOceanodeOSCVariablesController::draw() {
             strcpy(ipAddressBuffer, "127.0.0.1");  // Reset to localhost
             auxPort = 8000;     // Reset to default sender port
             oscMode = 0;        // Reset to default
+            transport = 0;
             ImGui::CloseCurrentPopup();
         }
         
@@ -809,52 +1475,67 @@ void ofxOceanodeOSCVariablesController::save() {
         // Basic group info
         groupJson["name"] = group->name;
         groupJson["mode"] = (group->oscMode == OscMode::Sender) ? "sender" : "receiver";
+        groupJson["transport"] = (group->transport == OscTransport::Tcp) ? "tcp" : "udp";
         
         // Save only relevant connection info based on mode
         if (group->oscMode == OscMode::Sender) {
             groupJson["host"] = group->ipParam;
             groupJson["port"] = group->portParam.get();  // Only save sender port for sender
+            groupJson["multicastTtl"] = group->multicastTtl;
+            groupJson["multicastInterface"] = group->multicastInterface;
+            groupJson["sendBufferSize"] = group->sendBufferSize;
+            groupJson["sequencing"] = group->sequencing;
+            groupJson["snapshots"] = group->snapshots;
+            groupJson["framed"] = group->framed;
         } else {
             groupJson["port"] = group->portParam.get();  // Only save receiver port for receiver
+            if (oscEndpoint::isUnixAddress(group->ipParam.get())) {
+                groupJson["host"] = group->ipParam;  // Local socket the receiver binds to
+            }
+            groupJson["multicastGroups"] = group->multicastGroups;
+            groupJson["multicastInterface"] = group->multicastInterface;
+            groupJson["receiveBufferSize"] = group->receiveBufferSize;
+            groupJson["snapshots"] = group->snapshots;
         }
         
         // Store parameters
         ofJson parametersJson = ofJson::array();
-        for(const auto& param : group->parameters) {
+        auto parameterTable = group->getParameters();
+        for(const auto& variable : parameterTable->variables) {
             ofJson paramJson;
-            paramJson["name"] = param->getName();
+            paramJson["name"] = variable.parameter->getName();
+            paramJson["type"] = variable.type->name;
             
-            if(param->isOfType<float>()) {
-                paramJson["type"] = "float";
+            if(group->isParameterReliable(variable.parameter->getName())) {
+                paramJson["reliable"] = true;
             }
-            else if(param->isOfType<int>()) {
-                paramJson["type"] = "int";
-            }
-            else if(param->isOfType<string>()) {
-                paramJson["type"] = "string";
-            }
-            else if(param->isOfType<vector<float>>()) {
-                paramJson["type"] = "float_vector";
-            }
-            else if(param->isOfType<vector<int>>()) {
-                paramJson["type"] = "int_vector";
-            }
-            else if(param->isOfType<vector<string>>()) {
-                paramJson["type"] = "string_vector";
+            if(variable.quantizer.isEnabled()) {
+                paramJson["quantize"] = oscQuantizer::toString(variable.quantizer.format);
+                paramJson["quantizeMin"] = variable.quantizer.min;
+                paramJson["quantizeMax"] = variable.quantizer.max;
             }
             
             parametersJson.push_back(paramJson);
         }
         groupJson["parameters"] = parametersJson;
+        groupJson["packed"] = group->packed;
+        groupJson["persistValues"] = group->persistValues;
+        if(group->persistValues) {
+            group->checkpointValues(true);
+        }
         
         json["groups"].push_back(groupJson);
     }
     
+    json["watch"] = watcher.isWatching();
+    
     if(ofSavePrettyJson("oscVars.json", json)) {
         ofLogNotice("ofxOceanodeOSCVariablesController") << "Successfully saved OSC configuration";
     } else {
         ofLogError("ofxOceanodeOSCVariablesController") << "Failed to save OSC configuration";
     }
+    // Our own write is not an edit to reload
+    watcher.acknowledge();
 }
 
 void ofxOceanodeOSCVariablesController::load() {
@@ -872,38 +1553,36 @@ void ofxOceanodeOSCVariablesController::load() {
         return;
     }
     
-    // Unregister all existing groups before loading new ones
-    for(auto &group : groups) {
-        string modName = (group->oscMode == OscMode::Sender) ? "Sender " : "Receiv. ";
-        container->getRegistry()->unregisterModel<oscVariables>("OSC Variables", modName + group->name, std::weak_ptr<oscVariablesGroup>());
-        
-        // Remove all nodes
-        for(auto* node : group->nodes) {
-            node->deleteSelf();
+    std::vector<oscGroupConfig> configs;
+    for(const auto& groupJson : json["groups"]) {
+        try {
+            configs.push_back(oscGroupConfig::fromJson(groupJson));
+        } catch(const std::exception& e) {
+            ofLogError("ofxOceanodeOSCVariablesController")
+            << "Failed to load group: " << e.what();
         }
     }
     
-    // Clear the groups list
-    groups.clear();
+    // Groups gone from the file go, as do groups that changed mode since that changes their node type
+    for(size_t i = groups.size(); i-- > 0;) {
+        auto group = groups[i];
+        auto config = std::find_if(configs.begin(), configs.end(), [&group](const auto &config){return config.name == group->name;});
+        if(config == configs.end() || config->mode != group->oscMode) {
+            removeGroup(group);
+        }
+    }
     
-    for(const auto& groupJson : json["groups"]) {
-        try {
-            string name = groupJson.value("name", "");
-            string modeStr = groupJson.value("mode", "sender");
-            OscMode mode = (modeStr == "sender") ? OscMode::Sender : OscMode::Receiver;
-            
-            // Default ports
-            int tmpPort = 8000;
-            string host = "127.0.0.1";
-            
-            // Get only relevant connection info based on mode
-            if (mode == OscMode::Sender) {
-                host = groupJson.value("host", "127.0.0.1");
-                tmpPort = groupJson.value("port", 8000);
-            } else {
-                tmpPort = groupJson.value("port", 9000);
+    for(const auto& config : configs) {
+        auto existing = std::find_if(groups.begin(), groups.end(), [&config](const auto &group){return group->name == config.name;});
+        if(existing != groups.end()) {
+            if((*existing)->applyConfig(config)) {
+                ofLogNotice("ofxOceanodeOSCVariablesController") << "Rebinding " << config.name;
+                (*existing)->resetOSCConnection();
             }
-            
+            continue;
+        }
+        
+        try {
             // Create the group using make_shared
             auto newGroup = std::make_shared<oscVariablesGroup>();
             
@@ -911,11 +1590,13 @@ void ofxOceanodeOSCVariablesController::load() {
             groups.push_back(newGroup);
             
             // Now initialize the members
-            newGroup->name = name;
+            newGroup->name = config.name;
             newGroup->container = container;
-            newGroup->oscMode = mode;
-            newGroup->portParam.set(tmpPort);
-            newGroup->ipParam.set(host);
+            newGroup->oscMode = config.mode;
+            newGroup->applyConfig(config);
+            if(config.persistValues) {
+                newGroup->restoreValues();
+            }
             
             // Initialize OSC after the group is fully set up
             newGroup->initializeOSC();
@@ -923,38 +1604,6 @@ void ofxOceanodeOSCVariablesController::load() {
             // Register the module
             newGroup->registerModule();
             
-            // Add parameters
-            if(groupJson.contains("parameters") && groupJson["parameters"].is_array()) {
-                for(const auto& paramJson : groupJson["parameters"]) {
-                    string paramName = paramJson.value("name", "");
-                    string paramType = paramJson.value("type", "");
-                    
-                    if(!paramName.empty() && !paramType.empty()) {
-                        if(paramType == "float") {
-                            newGroup->addFloatParameter(paramName);
-                        }
-                        else if(paramType == "int") {
-                            newGroup->addIntParameter(paramName);
-                        }
-                        else if(paramType == "string") {
-                            newGroup->addStringParameter(paramName);
-                        }
-                        else if(paramType == "float_vector") {
-                            vector<float> defaultVec = {0};
-                            newGroup->addFloatVectorParameter(paramName, defaultVec);
-                        }
-                        else if(paramType == "int_vector") {
-                            vector<int> defaultVec = {0};
-                            newGroup->addIntVectorParameter(paramName, defaultVec);
-                        }
-                        else if(paramType == "string_vector") {
-                            vector<string> defaultVec;
-                            newGroup->addStringVectorParameter(paramName, defaultVec);
-                        }
-                    }
-                }
-            }
-            
         } catch(const std::exception& e) {
             ofLogError("ofxOceanodeOSCVariablesController")
             << "Failed to load group: " << e.what();
@@ -965,4 +1614,54 @@ void ofxOceanodeOSCVariablesController::load() {
             }
         }
     }
+    
+    setWatching(json.value("watch", false));
+}
+
+oscGroupConfig oscGroupConfig::fromJson(const ofJson &groupJson) {
+    oscGroupConfig config;
+    config.name = groupJson.value("name", "");
+    string modeStr = groupJson.value("mode", "sender");
+    config.mode = (modeStr == "sender") ? OscMode::Sender : OscMode::Receiver;
+    config.transport = (groupJson.value("transport", "udp") == "tcp") ? OscTransport::Tcp : OscTransport::Udp;
+    
+    // Get only relevant connection info based on mode
+    if (config.mode == OscMode::Sender) {
+        config.host = groupJson.value("host", "127.0.0.1");
+        config.port = groupJson.value("port", 8000);
+        config.multicastTtl = groupJson.value("multicastTtl", 1);
+        config.multicastInterface = groupJson.value("multicastInterface", "");
+    } else {
+        config.port = groupJson.value("port", 9000);
+        config.host = groupJson.value("host", "");
+        config.multicastGroups = groupJson.value("multicastGroups", "");
+        config.multicastInterface = groupJson.value("multicastInterface", "");
+    }
+    config.receiveBufferSize = groupJson.value("receiveBufferSize", 0);
+    config.sendBufferSize = groupJson.value("sendBufferSize", 0);
+    config.sequencing = groupJson.value("sequencing", false);
+    config.snapshots = groupJson.value("snapshots", false);
+    config.framed = groupJson.value("framed", false);
+    config.packed = groupJson.value("packed", false);
+    config.persistValues = groupJson.value("persistValues", false);
+    
+    if(groupJson.contains("parameters") && groupJson["parameters"].is_array()) {
+        for(const auto& paramJson : groupJson["parameters"]) {
+            Variable variable;
+            variable.name = paramJson.value("name", "");
+            string paramType = paramJson.value("type", "");
+            if(variable.name.empty() || paramType.empty()) continue;
+            variable.type = oscVariableTypes::find(paramType);
+            if(variable.type == nullptr) {
+                ofLogError("ofxOceanodeOSCVariablesController") << "Unknown type " << paramType << " for variable " << variable.name;
+                continue;
+            }
+            variable.reliable = paramJson.value("reliable", false);
+            variable.quantizer.format = oscQuantizer::fromString(paramJson.value("quantize", "none"));
+            variable.quantizer.min = paramJson.value("quantizeMin", 0.0f);
+            variable.quantizer.max = paramJson.value("quantizeMax", 1.0f);
+            config.variables.push_back(variable);
+        }
+    }
+    return config;
 }
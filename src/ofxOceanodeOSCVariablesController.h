@@ -3,10 +3,20 @@
 
 #include "ofxOceanodeBaseController.h"
 #include "ofxOsc.h"
+#include "oscTransport.h"
+#include "oscCapture.h"
+#include "oscVariableCodec.h"
+#include "oscLearn.h"
+#include "oscConfigWatcher.h"
+#include "oscValueStore.h"
+#include "oscMonitor.h"
+#include "oscTrace.h"
 
 #include <sys/socket.h>
 #include <arpa/inet.h>
 
+#include <unordered_map>
+
 // Forward declare
 class oscVariables;
 
@@ -15,6 +25,71 @@ enum class OscMode {
     Receiver
 };
 
+// Udp datagrams, or a SLIP framed TCP stream for big or loss sensitive payloads
+enum class OscTransport {
+    Udp,
+    Tcp
+};
+
+// A group variable and the codec of its type, see oscVariableCodec.h
+struct oscVariable {
+    std::shared_ptr<ofAbstractParameter> parameter;
+    const oscVariableType *type = nullptr;
+    // Copies of the parameter name made once, the panel draws and filters on them every frame
+    std::string name;
+    std::string searchKey;  // Lowercase name
+    // Null unless the variable is monitored, see oscMonitor.h
+    std::shared_ptr<oscVariableMonitor> monitor;
+    // Position in the packed output of its lane, -1 if the type has none
+    int packedIndex = -1;
+    // Senders only, compact wire format of a float vector, see oscQuantize.h
+    oscQuantizer quantizer;
+};
+
+// Immutable variable list of a group. Edits publish a new table, so readers on
+// any thread keep using the one they loaded for as long as they hold it.
+struct oscParameterTable {
+    std::vector<oscVariable> variables;
+    std::unordered_map<std::string, size_t> byName;
+    size_t numPackedFloats = 0;
+    size_t numPackedInts = 0;
+    size_t numPackedStrings = 0;
+    
+    const oscVariable *find(const std::string &name) const {
+        auto variable = byName.find(name);
+        return variable != byName.end() ? &variables[variable->second] : nullptr;
+    };
+};
+
+// Settings of one group as stored in oscVars.json
+struct oscGroupConfig {
+    struct Variable {
+        std::string name;
+        const oscVariableType *type = nullptr;
+        bool reliable = false;
+        oscQuantizer quantizer;
+    };
+    
+    std::string name;
+    OscMode mode = OscMode::Sender;
+    OscTransport transport = OscTransport::Udp;
+    std::string host;
+    int port = 8000;
+    int multicastTtl = 1;
+    std::string multicastInterface;
+    std::string multicastGroups;
+    int receiveBufferSize = 0;
+    int sendBufferSize = 0;
+    bool sequencing = false;
+    bool snapshots = false;
+    bool framed = false;
+    bool packed = false;
+    bool persistValues = false;
+    std::vector<Variable> variables;
+    
+    static oscGroupConfig fromJson(const ofJson &json);
+};
+
 class oscVariablesGroup : public std::enable_shared_from_this<oscVariablesGroup> {
 public:
     // Default constructor
@@ -34,34 +109,156 @@ public:
     void registerModule();
     void addNode(oscVariables* node);
     void removeNode(oscVariables* node);
-    void addFloatParameter(std::string parameterName, float value = 0);
-    void addStringParameter(std::string parameterName, std::string value = "");
-    void addFloatVectorParameter(std::string parameterName, std::vector<float> value = std::vector<float>());
-    void addStringVectorParameter(std::string parameterName, std::vector<string> value = std::vector<string>());
-    void addIntParameter(std::string parameterName, int value = 0);
-    void addIntVectorParameter(std::string parameterName, std::vector<int> value = std::vector<int>());
-        
+    // New variable with the default value of its type, see oscVariableTypes::all()
+    void addParameter(const std::string &parameterName, const oscVariableType &type);
+    
     void removeParameter(std::string parameterName);
+    
+    // Brings the group in line with config without touching what did not change:
+    // variables are added or removed one by one and socket options applied in
+    // place. Returns true if the socket has to be set up again.
+    bool applyConfig(const oscGroupConfig &config);
+    
+    // Current variable table, lock free and safe to call from network threads
+    std::shared_ptr<const oscParameterTable> getParameters() const {return std::atomic_load(&parameterTable);};
+    
+    // Adds or removes the packed outputs on every node of the group
+    void setPacked(bool enabled);
+    
+    // Values sidecar of the group, next to oscVars.json
+    std::string getValuesPath() const;
+    // Sets the variables to the values last checkpointed, false if there were none
+    bool restoreValues();
+    // Snapshots the values for the background writer, at most every
+    // OSC_VALUES_CHECKPOINT_MS unless forced. Only the encoding runs on the caller.
+    void checkpointValues(bool force = false);
+    
+    // Receivers only, a variable for every learned address a type can be guessed for.
+    // Returns how many were created, the learned table is cleared.
+    size_t createLearnedVariables();
     void resetOSCConnection();
+    // Called once per frame by the controller, never by nodes
     void update();
     
+    // Sends through the reliable stream when the variable is flagged as reliable
+    void sendMessage(const ofxOscMessage &message);
+    // Encodes the current value of a variable and sends it
+    void sendParameter(const std::string &parameterName);
+    void setParameterReliable(const std::string &parameterName, bool reliable);
+    bool isParameterReliable(const std::string &parameterName) const {return reliableParameters.count(parameterName) != 0;};
+    
+    // Float vectors only, other variables always send their plain encoding.
+    // Receivers read quantized vectors of any format without a setting.
+    void setParameterQuantizer(const std::string &parameterName, const oscQuantizer &quantizer);
+    
+    // Records the messages of the variable as they are sent or received. Groups
+    // without monitored variables do not look at their traffic at all.
+    void setParameterMonitored(const std::string &parameterName, bool monitored);
+    
+    // Sender destination or receiver bind address, ipParam may hold "unix:/path"
+    oscEndpoint getEndpoint() const;
+    
+    // Current value of a variable as the message its listener would send, quantized if it is
+    void getParameterMessage(const oscVariable &variable, ofxOscMessage &message) const;
+    
+    // Receivers only, raw traffic capture and replay, see oscCapture.h
+    bool startRecording(const std::string &path);
+    void stopRecording();
+    // Live input is paused while playing, speed 0 plays as fast as possible.
+    // Playing from startSeconds first restores the values the group had then.
+    bool startPlayback(const std::string &path, float speed, double startSeconds = 0);
+    void stopPlayback();
+    
 //    bool isMyOSCPortAvailable(int port);
     
     std::string name;
     OscMode oscMode;
+    OscTransport transport = OscTransport::Udp;
     
     ofParameter<int> portParam;
-    ofParameter<string> ipParam;
+    ofParameter<string> ipParam;  // Single host or comma separated destination list for senders
+    
+    // Applied when the destination list contains multicast groups
+    int multicastTtl = 1;
+    std::string multicastInterface;
+    // Receivers only, comma separated multicast groups joined on portParam
+    std::string multicastGroups;
+    
+    // Kernel socket buffers in bytes, 0 keeps the system default
+    int receiveBufferSize = 0;
+    int sendBufferSize = 0;
+    
+    // Senders only, adds a "/_seq" header so receivers can detect loss and reordering
+    bool sequencing = false;
+    
+    // Late joiner sync, off by default: senders answer with the value of every
+    // variable, receivers ask every sender they start hearing from
+    bool snapshots = false;
+    
+    // Senders only, changes made in one frame are applied together by receivers, see oscFrame.h
+    bool framed = false;
+    
+    // Every float, int and string variable also in one vector output per type,
+    // in variable order and refreshed once per update(), see oscVariable::packedIndex
+    bool packed = false;
+    ofParameter<std::vector<float>> packedFloats;
+    ofParameter<std::vector<int>> packedInts;
+    ofParameter<std::vector<std::string>> packedStrings;
+    
+    // Values survive restarts through a binary sidecar, see oscValueStore.h
+    bool persistValues = false;
     
-    ofxOscSender sender;
-    ofxOscReceiver receiver;
+    // Receivers only, messages for unknown addresses are sampled into learned, see oscLearn.h
+    bool learning = false;
+    oscLearnTable learned;
+    
+    // Messages dropped by update() because a newer one for the same address arrived
+    uint64_t messagesCoalesced = 0;
+    
+    // Senders only, variables retransmitted on NACK, see oscReliable.h
+    std::set<std::string> reliableParameters;
+    
+    // Declared before the receiver, which is destroyed first and detaches from them
+    oscCaptureRecorder recorder;
+    oscCapturePlayer player;
+    oscTransportSender sender;
+    oscTransportReceiver receiver;
     
-    std::vector<std::shared_ptr<ofAbstractParameter>> parameters;
     std::vector<oscVariables*> nodes;
     std::shared_ptr<ofxOceanodeContainer> container;
     
 private:
+    // Copies the table, applies edit and swaps the copy in. Tables still held
+    // by readers are freed when the last of them lets go.
+    void publishParameters(const std::function<void(std::vector<oscVariable>&)> &edit);
+    
+    void addPackedOutputs(oscVariables *node);
+    // Copies the variables into the packed buffers, outputs only notify when their buffer changed
+    void updatePacked(const oscParameterTable &table);
+    
+    // Send path or receive thread, hands the message to the monitor of its variable
+    void recordSample(const ofxOscMessage &message);
+    
+    std::shared_ptr<const oscParameterTable> parameterTable = std::make_shared<oscParameterTable>();
+    std::vector<float> packedFloatValues;
+    std::vector<int> packedIntValues;
+    std::vector<std::string> packedStringValues;
+    // Serializes writers only, readers never take it
     std::mutex parameterMutex;
+    
+    oscValueStore valueStore;
+    oscPacketWriter valueWriter{OSC_STREAM_MAX_PACKET};
+    uint64_t lastCheckpoint = 0;
+    size_t monitoredParameters = 0;
+    
+    // Framed mode, latest message per address since the last update()
+    std::vector<ofxOscMessage> frameMessages;
+    std::map<std::string, size_t> frameIndices;
+    // Receiver side batch swapped out of the receiver every update()
+    std::deque<ofxOscMessage> receivedMessages;
+    // Variables set by the current batch, notified once all of them are
+    std::vector<const oscVariable*> stagedVariables;
+    bool playbackActive = false;
 };
 
 //-------------------------------------------------------------------------
@@ -75,10 +272,19 @@ public:
     void draw();
     
     void save();
+    // Applies oscVars.json over the live groups, only what changed is rebuilt
     void load();
     
+    // Reloads whenever oscVars.json changes on disk, see oscConfigWatcher.h
+    void setWatching(bool watching);
+    
 private:
+    // Unregisters the node type and deletes every node of the group
+    void removeGroup(std::shared_ptr<oscVariablesGroup> group);
+    
     shared_ptr<ofxOceanodeContainer> container;
+    oscConfigWatcher watcher;
+    ofEventListener updateListener;
     
     std::vector<std::shared_ptr<oscVariablesGroup>> groups;
 };
@@ -0,0 +1,421 @@
+//
+//  oscCapture.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscCapture.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+// Messages a receiver may have queued before the player drains them itself at speed 0
+#define OSC_CAPTURE_MAX_QUEUED (64 * 1024)
+
+#define OSC_CAPTURE_INDEX_VERSION 1
+#define OSC_CAPTURE_INDEX_HEADER_SIZE 16
+#define OSC_CAPTURE_INDEX_ENTRY_SIZE 20
+
+static void appendBytes(std::vector<char> &buffer, const void *data, size_t size){
+    const char *bytes = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+static bool writeAll(int fd, const std::vector<char> &buffer, const std::string &path){
+    size_t written = 0;
+    while(written < buffer.size()){
+        ssize_t result = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if(result < 0){
+            if(errno == EINTR) continue;
+            ofLogError("oscCapture") << "Write to " << path << " failed: " << strerror(errno);
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// oscCaptureState
+//-------------------------------------------------------------------------
+
+void oscCaptureState::apply(const char *data, size_t size){
+    received.clear();
+    if(!oscPacketReader::read(data, size, received)) return;
+    for(auto &message : received){
+        if(message.getAddress().compare(0, 2, "/_") == 0) continue;
+        // Copy the address first, the message is moved from in the same statement
+        std::string address = message.getAddress();
+        messages[address] = std::move(message);
+    }
+}
+
+bool oscCaptureState::write(oscPacketWriter &writer) const{
+    if(messages.empty()) return false;
+    ofxOscBundle bundle;
+    for(auto &message : messages){
+        bundle.addMessage(message.second);
+    }
+    return writer.writeBundle(bundle);
+}
+
+//-------------------------------------------------------------------------
+// oscCaptureIndexBuilder
+//-------------------------------------------------------------------------
+
+oscCaptureIndexBuilder::oscCaptureIndexBuilder() : writer(OSC_STREAM_MAX_PACKET){
+}
+
+void oscCaptureIndexBuilder::reset(){
+    state.clear();
+    buffer.clear();
+    uint32_t version = OSC_CAPTURE_INDEX_VERSION;
+    uint64_t reserved = 0;
+    appendBytes(buffer, OSC_CAPTURE_INDEX_MAGIC, 4);
+    appendBytes(buffer, &version, sizeof(version));
+    appendBytes(buffer, &reserved, sizeof(reserved));
+    nextEntry = 0;
+    nextKeyframe = 0;
+}
+
+void oscCaptureIndexBuilder::add(uint64_t time, uint64_t offset, const char *data, size_t size){
+    if(time >= nextKeyframe){
+        appendEntry(time, offset, true);
+        nextKeyframe = (time / OSC_CAPTURE_KEYFRAME_INTERVAL + 1) * OSC_CAPTURE_KEYFRAME_INTERVAL;
+        nextEntry = (time / OSC_CAPTURE_INDEX_INTERVAL + 1) * OSC_CAPTURE_INDEX_INTERVAL;
+    }else if(time >= nextEntry){
+        appendEntry(time, offset, false);
+        nextEntry = (time / OSC_CAPTURE_INDEX_INTERVAL + 1) * OSC_CAPTURE_INDEX_INTERVAL;
+    }
+    state.apply(data, size);
+}
+
+void oscCaptureIndexBuilder::finish(uint64_t time, uint64_t offset){
+    appendEntry(time, offset, false);
+}
+
+void oscCaptureIndexBuilder::appendEntry(uint64_t time, uint64_t offset, bool keyframe){
+    uint32_t keyframeSize = 0;
+    if(keyframe && state.write(writer)) keyframeSize = writer.size();
+    appendBytes(buffer, &time, sizeof(time));
+    appendBytes(buffer, &offset, sizeof(offset));
+    appendBytes(buffer, &keyframeSize, sizeof(keyframeSize));
+    if(keyframeSize > 0){
+        appendBytes(buffer, writer.data(), keyframeSize);
+        buffer.resize((buffer.size() + 3) & ~size_t(3), 0);
+    }
+}
+
+//-------------------------------------------------------------------------
+// oscCaptureIndex
+//-------------------------------------------------------------------------
+
+bool oscCaptureIndex::load(const std::string &indexPath, const oscCaptureReader &reader){
+    entries.clear();
+    ofBuffer file = ofBufferFromFile(indexPath, true);
+    const char *data = file.getData();
+    size_t size = file.size();
+    uint32_t version = 0;
+    if(size >= OSC_CAPTURE_INDEX_HEADER_SIZE) memcpy(&version, data + 4, sizeof(version));
+    if(size < OSC_CAPTURE_INDEX_HEADER_SIZE || memcmp(data, OSC_CAPTURE_INDEX_MAGIC, 4) != 0 || version != OSC_CAPTURE_INDEX_VERSION){
+        return false;
+    }
+    size_t offset = OSC_CAPTURE_INDEX_HEADER_SIZE;
+    while(offset + OSC_CAPTURE_INDEX_ENTRY_SIZE <= size){
+        Entry entry;
+        uint32_t keyframeSize;
+        memcpy(&entry.time, data + offset, sizeof(entry.time));
+        memcpy(&entry.offset, data + offset + 8, sizeof(entry.offset));
+        memcpy(&keyframeSize, data + offset + 16, sizeof(keyframeSize));
+        size_t payload = offset + OSC_CAPTURE_INDEX_ENTRY_SIZE;
+        // Entries that point past the capture belong to another recording
+        if(payload + keyframeSize > size || entry.offset > reader.getFileSize()) break;
+        entry.keyframe.assign(data + payload, data + payload + keyframeSize);
+        entries.push_back(std::move(entry));
+        offset = (payload + keyframeSize + 3) & ~size_t(3);
+    }
+    return !entries.empty();
+}
+
+bool oscCaptureIndex::build(const oscCaptureReader &reader, const std::string &indexPath){
+    entries.clear();
+    oscCaptureIndexBuilder builder;
+    builder.reset();
+    size_t offset = reader.begin();
+    uint64_t time = 0;
+    oscCaptureReader::Record record;
+    for(size_t recordOffset = offset; reader.next(offset, record); recordOffset = offset){
+        builder.add(record.time, recordOffset, record.data, record.size);
+        time = record.time;
+    }
+    builder.finish(time, offset);
+
+    int fd = ::open(indexPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0){
+        ofLogError("oscCaptureIndex") << "Could not open " << indexPath << ": " << strerror(errno);
+    }else{
+        writeAll(fd, builder.getBuffer(), indexPath);
+        ::close(fd);
+    }
+    return load(indexPath, reader);
+}
+
+const oscCaptureIndex::Entry *oscCaptureIndex::findKeyframe(uint64_t time) const{
+    auto entry = std::upper_bound(entries.begin(), entries.end(), time, [](uint64_t time, const Entry &entry){
+        return time < entry.time;
+    });
+    while(entry != entries.begin()){
+        --entry;
+        if(!entry->keyframe.empty()) return &*entry;
+    }
+    return nullptr;
+}
+
+//-------------------------------------------------------------------------
+// oscCaptureRecorder
+//-------------------------------------------------------------------------
+
+oscCaptureRecorder::~oscCaptureRecorder(){
+    stop();
+}
+
+bool oscCaptureRecorder::start(const std::string &_path){
+    stop();
+    std::lock_guard<std::mutex> lock(mutex);
+    path = _path;
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if(fd < 0){
+        ofLogError("oscCaptureRecorder") << "Could not open " << path << ": " << strerror(errno);
+        return false;
+    }
+    std::string indexPath = path + OSC_CAPTURE_INDEX_EXTENSION;
+    indexFd = ::open(indexPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if(indexFd < 0){
+        // The capture is still usable, the player rebuilds a missing index
+        ofLogWarning("oscCaptureRecorder") << "Could not open " << indexPath << ": " << strerror(errno);
+    }
+    index.reset();
+    buffer.clear();
+    buffer.reserve(OSC_CAPTURE_WRITE_BUFFER);
+    uint32_t version = OSC_CAPTURE_VERSION;
+    uint64_t startNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    appendBytes(buffer, OSC_CAPTURE_MAGIC, 4);
+    appendBytes(buffer, &version, sizeof(version));
+    appendBytes(buffer, &startNs, sizeof(startNs));
+    startTime = std::chrono::steady_clock::now();
+    offset = OSC_CAPTURE_HEADER_SIZE;
+    lastTime = 0;
+    packets = 0;
+    bytes = 0;
+    recording = true;
+    return true;
+}
+
+void oscCaptureRecorder::stop(){
+    std::lock_guard<std::mutex> lock(mutex);
+    if(fd < 0) return;
+    recording = false;
+    index.finish(lastTime, offset);
+    flush();
+    ::close(fd);
+    fd = -1;
+    if(indexFd >= 0){
+        ::close(indexFd);
+        indexFd = -1;
+    }
+}
+
+void oscCaptureRecorder::record(const char *data, size_t size){
+    if(!recording) return;
+    std::lock_guard<std::mutex> lock(mutex);
+    if(fd < 0) return;
+    uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+    uint32_t recordSize = size;
+    index.add(time, offset, data, size);
+    size_t start = buffer.size();
+    appendBytes(buffer, &time, sizeof(time));
+    appendBytes(buffer, &recordSize, sizeof(recordSize));
+    appendBytes(buffer, data, size);
+    buffer.resize((buffer.size() + 3) & ~size_t(3), 0);
+    offset += buffer.size() - start;
+    lastTime = time;
+    packets++;
+    bytes += size;
+    if(buffer.size() >= OSC_CAPTURE_WRITE_BUFFER) flush();
+}
+
+void oscCaptureRecorder::flush(){
+    if(!writeAll(fd, buffer, path)) recording = false;
+    buffer.clear();
+    // The index never points past what is already in the capture
+    if(indexFd >= 0 && !writeAll(indexFd, index.getBuffer(), path + OSC_CAPTURE_INDEX_EXTENSION)){
+        ::close(indexFd);
+        indexFd = -1;
+    }
+    index.clearBuffer();
+}
+
+//-------------------------------------------------------------------------
+// oscCaptureReader
+//-------------------------------------------------------------------------
+
+oscCaptureReader::~oscCaptureReader(){
+    close();
+}
+
+bool oscCaptureReader::open(const std::string &path){
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        ofLogError("oscCaptureReader") << "Could not open " << path << ": " << strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size < OSC_CAPTURE_HEADER_SIZE){
+        ofLogError("oscCaptureReader") << path << " is not a capture file";
+        ::close(fd);
+        return false;
+    }
+    void *address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(address == MAP_FAILED){
+        ofLogError("oscCaptureReader") << "Could not map " << path << ": " << strerror(errno);
+        return false;
+    }
+    mapped = static_cast<const char*>(address);
+    size = info.st_size;
+
+    uint32_t version;
+    memcpy(&version, mapped + 4, sizeof(version));
+    if(memcmp(mapped, OSC_CAPTURE_MAGIC, 4) != 0 || version != OSC_CAPTURE_VERSION){
+        ofLogError("oscCaptureReader") << path << " is not a capture file, or of an unknown version";
+        close();
+        return false;
+    }
+    memcpy(&startTime, mapped + 8, sizeof(startTime));
+    // Records are read sequentially from start to end
+    madvise(const_cast<char*>(mapped), size, MADV_SEQUENTIAL);
+    return true;
+}
+
+void oscCaptureReader::close(){
+    if(mapped != nullptr){
+        munmap(const_cast<char*>(mapped), size);
+        mapped = nullptr;
+    }
+    size = 0;
+    startTime = 0;
+}
+
+bool oscCaptureReader::next(size_t &offset, Record &record) const{
+    if(mapped == nullptr || offset + OSC_CAPTURE_RECORD_HEADER_SIZE > size) return false;
+    uint32_t recordSize;
+    memcpy(&record.time, mapped + offset, sizeof(record.time));
+    memcpy(&recordSize, mapped + offset + 8, sizeof(recordSize));
+    size_t payload = offset + OSC_CAPTURE_RECORD_HEADER_SIZE;
+    // A truncated last record ends the file
+    if(payload + recordSize > size) return false;
+    record.data = mapped + payload;
+    record.size = recordSize;
+    offset = (payload + recordSize + 3) & ~size_t(3);
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// oscCapturePlayer
+//-------------------------------------------------------------------------
+
+oscCapturePlayer::~oscCapturePlayer(){
+    stop();
+}
+
+bool oscCapturePlayer::play(const std::string &path, oscTransportReceiver &receiver, float speed, double startSeconds){
+    stop();
+    if(!reader.open(path)) return false;
+    std::string indexPath = path + OSC_CAPTURE_INDEX_EXTENSION;
+    if(!index.load(indexPath, reader)){
+        ofLogNotice("oscCapturePlayer") << "Building index " << indexPath;
+        index.build(reader, indexPath);
+    }
+    duration = index.getDuration() / 1e9;
+    progress = 0;
+    packets = 0;
+    seekMilliseconds = 0;
+    // Sequences and frames of an earlier run, or of this capture live, would be dropped as old
+    receiver.resetTracking();
+    playing = true;
+    thread = std::thread(&oscCapturePlayer::threadedFunction, this, &receiver, std::max(speed, 0.0f), uint64_t(std::max(startSeconds, 0.0) * 1e9));
+    return true;
+}
+
+void oscCapturePlayer::stop(){
+    playing = false;
+    if(thread.joinable()){
+        thread.join();
+    }
+    reader.close();
+}
+
+size_t oscCapturePlayer::restoreState(oscTransportReceiver *receiver, uint64_t time){
+    oscCaptureState state;
+    size_t offset = reader.begin();
+    const oscCaptureIndex::Entry *keyframe = index.findKeyframe(time);
+    if(keyframe != nullptr){
+        state.apply(keyframe->keyframe.data(), keyframe->keyframe.size());
+        offset = keyframe->offset;
+    }
+    oscCaptureReader::Record record;
+    for(size_t next = offset; reader.next(next, record) && record.time < time; offset = next){
+        state.apply(record.data, record.size);
+    }
+    oscPacketWriter writer(OSC_STREAM_MAX_PACKET);
+    if(state.write(writer)){
+        receiver->injectPacket(writer.data(), writer.size());
+    }
+    return offset;
+}
+
+void oscCapturePlayer::threadedFunction(oscTransportReceiver *receiver, float speed, uint64_t startTime){
+    size_t offset = reader.begin();
+    if(startTime > 0){
+        auto seekStart = std::chrono::steady_clock::now();
+        offset = restoreState(receiver, startTime);
+        seekMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - seekStart).count();
+    }
+    auto start = std::chrono::steady_clock::now();
+    oscCaptureReader::Record record;
+    uint64_t bytes = 0;
+    // Speed 0 measures parsing, sequencing and demultiplexing alone: the player
+    // empties the queue itself instead of waiting for the group's next frame
+    std::deque<ofxOscMessage> drained;
+    while(playing && reader.next(offset, record)){
+        if(speed > 0){
+            uint64_t time = record.time > startTime ? record.time - startTime : 0;
+            auto due = start + std::chrono::nanoseconds(uint64_t(time / speed));
+            // Short sleeps so stop() never waits long
+            while(playing && std::chrono::steady_clock::now() < due){
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(due - std::chrono::steady_clock::now(), std::chrono::milliseconds(10)));
+            }
+        }else if(receiver->getNumWaitingMessages() > OSC_CAPTURE_MAX_QUEUED){
+            receiver->takeMessages(drained);
+        }
+        receiver->injectPacket(record.data, record.size);
+        packets++;
+        bytes += record.size;
+        progress = float(offset) / float(reader.getFileSize());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if(seconds > 0){
+        packetsPerSecond = packets / seconds;
+        bytesPerSecond = bytes / seconds;
+    }
+    // Values drained above never reached the group, it gets the final state instead
+    if(speed == 0 && playing){
+        restoreState(receiver, UINT64_MAX);
+    }
+    playing = false;
+}
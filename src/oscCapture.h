@@ -0,0 +1,228 @@
+//
+//  oscCapture.h
+//  ofxOceanodeOsc
+//
+//  Capture files of the raw packets a receiver saw, and a player that feeds
+//  them back into a receiver without any socket.
+//
+//  Layout, little endian, append only:
+//      header  "OSCC" | u32 version | u64 start time (ns since epoch)
+//      record  u64 time (ns since start) | u32 size | payload, padded to 4 bytes
+//  A file that is still being written, or was cut short, is valid up to its
+//  last complete record.
+//
+//  The recorder also writes "<capture>.idx" as it goes, a sparse time index
+//  with a keyframe (the latest message of every address, as one OSC bundle)
+//  every few seconds:
+//      header  "OSCI" | u32 version | u64 reserved
+//      entry   u64 time | u64 capture offset | u32 keyframe size | keyframe, padded to 4 bytes
+//  Keyframes hold the state before the record at their offset. Seeking applies
+//  the nearest keyframe, folds in the records up to the target time and hands
+//  the result to the receiver as a single packet.
+//
+
+#ifndef oscCapture_h
+#define oscCapture_h
+
+#include "ofMain.h"
+#include "oscTransport.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#define OSC_CAPTURE_MAGIC "OSCC"
+#define OSC_CAPTURE_VERSION 1
+#define OSC_CAPTURE_HEADER_SIZE 16
+#define OSC_CAPTURE_RECORD_HEADER_SIZE 12
+// Bytes buffered by the recorder before they are written out
+#define OSC_CAPTURE_WRITE_BUFFER (256 * 1024)
+
+#define OSC_CAPTURE_INDEX_MAGIC "OSCI"
+#define OSC_CAPTURE_INDEX_EXTENSION ".idx"
+// Spacing of index entries and of keyframes, in ns of capture time
+#define OSC_CAPTURE_INDEX_INTERVAL 1000000000ull
+#define OSC_CAPTURE_KEYFRAME_INTERVAL 10000000000ull
+
+//-------------------------------------------------------------------------
+// oscCaptureState - Latest message of every address seen in a capture
+//-------------------------------------------------------------------------
+class oscCaptureState {
+public:
+    // Protocol headers ("/_seq", "/_frame", ...) are not state and are skipped
+    void apply(const char *data, size_t size);
+    // All messages as one bundle, false if there is nothing to write
+    bool write(oscPacketWriter &writer) const;
+    void clear() {messages.clear();};
+
+private:
+    std::map<std::string, ofxOscMessage> messages;
+    std::vector<ofxOscMessage> received;
+};
+
+//-------------------------------------------------------------------------
+// oscCaptureIndexBuilder - Produces index entries while records are appended
+//-------------------------------------------------------------------------
+class oscCaptureIndexBuilder {
+public:
+    oscCaptureIndexBuilder();
+
+    void reset();
+    // Adds the entries due at this record, then folds the record into the state
+    void add(uint64_t time, uint64_t offset, const char *data, size_t size);
+    // Last entry, marks the end of the capture
+    void finish(uint64_t time, uint64_t offset);
+
+    // Bytes produced since the last call to clearBuffer(), header included at first
+    const std::vector<char> &getBuffer() const {return buffer;};
+    void clearBuffer() {buffer.clear();};
+
+private:
+    void appendEntry(uint64_t time, uint64_t offset, bool keyframe);
+
+    oscCaptureState state;
+    oscPacketWriter writer;
+    std::vector<char> buffer;
+    uint64_t nextEntry = 0;
+    uint64_t nextKeyframe = 0;
+};
+
+//-------------------------------------------------------------------------
+// oscCaptureIndex - Loaded (or rebuilt) index of one capture
+//-------------------------------------------------------------------------
+class oscCaptureReader;
+
+class oscCaptureIndex {
+public:
+    struct Entry {
+        uint64_t time = 0;
+        uint64_t offset = 0;
+        std::vector<char> keyframe;    // Empty for plain time entries
+    };
+
+    bool load(const std::string &indexPath, const oscCaptureReader &reader);
+    // Scans the whole capture once, for files recorded without an index
+    bool build(const oscCaptureReader &reader, const std::string &indexPath);
+    void clear() {entries.clear();};
+
+    // Latest keyframe at or before time, null if there is none
+    const Entry *findKeyframe(uint64_t time) const;
+    uint64_t getDuration() const {return entries.empty() ? 0 : entries.back().time;};
+
+private:
+    std::vector<Entry> entries;
+};
+
+class oscTransportReceiver;
+
+//-------------------------------------------------------------------------
+// oscCaptureRecorder - Appends packets to a capture file
+//
+// record() is called from the receive thread, everything else from the main
+// thread.
+//-------------------------------------------------------------------------
+class oscCaptureRecorder {
+public:
+    ~oscCaptureRecorder();
+
+    // Also writes path + OSC_CAPTURE_INDEX_EXTENSION
+    bool start(const std::string &path);
+    void stop();
+    bool isRecording() const {return recording;};
+
+    void record(const char *data, size_t size);
+
+    const std::string &getPath() const {return path;};
+    uint64_t getPackets() const {return packets;};
+    uint64_t getBytes() const {return bytes;};
+
+private:
+    void flush();
+
+    std::mutex mutex;
+    int fd = -1;
+    int indexFd = -1;
+    std::string path;
+    std::vector<char> buffer;
+    oscCaptureIndexBuilder index;
+    uint64_t offset = 0;
+    uint64_t lastTime = 0;
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<bool> recording{false};
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+//-------------------------------------------------------------------------
+// oscCaptureReader - Read only mapping of a capture file
+//-------------------------------------------------------------------------
+class oscCaptureReader {
+public:
+    struct Record {
+        uint64_t time = 0;       // ns since the start of the capture
+        const char *data = nullptr;
+        size_t size = 0;
+    };
+
+    ~oscCaptureReader();
+
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const {return mapped != nullptr;};
+
+    // Offset of the first record, pass it to next() to walk the file
+    size_t begin() const {return OSC_CAPTURE_HEADER_SIZE;};
+    // Reads the record at offset and advances it, false at the end of the file
+    bool next(size_t &offset, Record &record) const;
+
+    uint64_t getStartTime() const {return startTime;};
+    size_t getFileSize() const {return size;};
+
+private:
+    const char *mapped = nullptr;
+    size_t size = 0;
+    uint64_t startTime = 0;
+};
+
+//-------------------------------------------------------------------------
+// oscCapturePlayer - Feeds a capture into a receiver from its own thread
+//-------------------------------------------------------------------------
+class oscCapturePlayer {
+public:
+    ~oscCapturePlayer();
+
+    // speed 1 plays in real time, 0 as fast as the receive path can take it.
+    // At 0 the player drains the receiver itself, so the group sees only part
+    // of the messages and then the state at the end of the capture.
+    // A start time restores the state at that point first, see oscCaptureIndex.
+    bool play(const std::string &path, oscTransportReceiver &receiver, float speed, double startSeconds = 0);
+    void stop();
+    bool isPlaying() const {return playing;};
+
+    float getProgress() const {return progress;};
+    // Length of the last capture played, from its index
+    double getDuration() const {return duration;};
+    // Time the last seek took to restore the state
+    double getSeekMilliseconds() const {return seekMilliseconds;};
+    uint64_t getPackets() const {return packets;};
+    // Throughput of the last run, meaningful in as fast as possible mode
+    double getPacketsPerSecond() const {return packetsPerSecond;};
+    double getBytesPerSecond() const {return bytesPerSecond;};
+
+private:
+    void threadedFunction(oscTransportReceiver *receiver, float speed, uint64_t startTime);
+    size_t restoreState(oscTransportReceiver *receiver, uint64_t time);
+
+    oscCaptureReader reader;
+    oscCaptureIndex index;
+    std::atomic<double> duration{0};
+    std::atomic<double> seekMilliseconds{0};
+    std::thread thread;
+    std::atomic<bool> playing{false};
+    std::atomic<float> progress{0};
+    std::atomic<uint64_t> packets{0};
+    std::atomic<double> packetsPerSecond{0};
+    std::atomic<double> bytesPerSecond{0};
+};
+
+#endif /* oscCapture_h */
@@ -0,0 +1,137 @@
+//
+//  oscChannel.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscChannel.h"
+#include "oscVariableCodec.h"
+
+// Branch free clamp in place over contiguous values, so the compiler vectorizes it
+template<typename T>
+static void clampValues(std::vector<T> &values, T min, T max){
+    T *data = values.data();
+    for(size_t i = 0; i < values.size(); i++){
+        data[i] = std::min(std::max(data[i], min), max);
+    }
+}
+
+std::vector<oscChannel> oscChannel::compile(const std::string &configuration, const std::string &nodeName){
+    std::vector<oscChannel> channels;
+    for(auto &entry : ofSplitString(configuration, ", ")){
+        std::vector<std::string> fields = ofSplitString(entry, ":");
+        if(fields.size() < 2) continue;
+        oscChannel channel;
+        const std::string &name = fields[1];
+        channel.address = (name == nodeName) ? "/" + nodeName : "/" + nodeName + "/" + name;
+        if(fields.size() >= 4){
+            channel.minFloat = ofToFloat(fields[2]);
+            channel.maxFloat = ofToFloat(fields[3]);
+            channel.minInt = ofToInt(fields[2]);
+            channel.maxInt = ofToInt(fields[3]);
+        }
+        if(fields[0] == "f"){
+            channel.type = Type::Float;
+            auto parameter = std::make_shared<ofParameter<float>>();
+            parameter->set(name, channel.minFloat, channel.minFloat, channel.maxFloat);
+            channel.parameter = parameter;
+        }else if(fields[0] == "vf"){
+            channel.type = Type::FloatVector;
+            auto parameter = std::make_shared<ofParameter<std::vector<float>>>();
+            parameter->set(name, std::vector<float>(1, channel.minFloat), std::vector<float>(1, channel.minFloat), std::vector<float>(1, channel.maxFloat));
+            channel.parameter = parameter;
+        }else if(fields[0] == "i"){
+            channel.type = Type::Int;
+            auto parameter = std::make_shared<ofParameter<int>>();
+            parameter->set(name, channel.minInt, channel.minInt, channel.maxInt);
+            channel.parameter = parameter;
+        }else if(fields[0] == "vi"){
+            channel.type = Type::IntVector;
+            auto parameter = std::make_shared<ofParameter<std::vector<int>>>();
+            parameter->set(name, std::vector<int>(1, channel.minInt), std::vector<int>(1, channel.minInt), std::vector<int>(1, channel.maxInt));
+            channel.parameter = parameter;
+        }else if(fields[0] == "s"){
+            channel.type = Type::String;
+            auto parameter = std::make_shared<ofParameter<std::string>>();
+            parameter->set(name, "");
+            channel.parameter = parameter;
+        }else{
+            ofLogWarning("oscChannel") << "Unknown channel type " << fields[0] << " in " << entry;
+            continue;
+        }
+        channels.push_back(channel);
+    }
+    return channels;
+}
+
+void oscChannel::encode(ofxOscMessage &message) const{
+    message.setAddress(address);
+    switch(type){
+        case Type::Float:
+            message.addFloatArg(ofClamp(typed<float>().get(), minFloat, maxFloat));
+            break;
+        case Type::Int:
+            message.addIntArg(ofClamp(typed<int>().get(), minInt, maxInt));
+            break;
+        // Clamped while appending, one pass and no copy of the vector
+        case Type::FloatVector:
+            for(float value : typed<std::vector<float>>().get()) message.addFloatArg(std::min(std::max(value, minFloat), maxFloat));
+            break;
+        case Type::IntVector:
+            for(int value : typed<std::vector<int>>().get()) message.addIntArg(std::min(std::max(value, minInt), maxInt));
+            break;
+        case Type::String:
+            message.addStringArg(typed<std::string>().get());
+            break;
+    }
+}
+
+bool oscChannel::decode(const ofxOscMessage &message) const{
+    // Reused by every channel decoded on this thread
+    static thread_local std::vector<float> floats;
+    static thread_local std::vector<int> ints;
+    if(message.getNumArgs() == 0) return false;
+    switch(type){
+        case Type::Float:{
+            float value;
+            if(!oscVariableArgs::as(message, 0, value)) return false;
+            typed<float>() = ofClamp(value, minFloat, maxFloat);
+            return true;
+        }
+        case Type::Int:{
+            int value;
+            if(!oscVariableArgs::as(message, 0, value)) return false;
+            typed<int>() = ofClamp(value, minInt, maxInt);
+            return true;
+        }
+        case Type::FloatVector:{
+            if(!oscVariableArgs::asVector(message, floats)) return false;
+            clampValues(floats, minFloat, maxFloat);
+            typed<std::vector<float>>() = floats;
+            return true;
+        }
+        case Type::IntVector:{
+            if(!oscVariableArgs::asVector(message, ints)) return false;
+            clampValues(ints, minInt, maxInt);
+            typed<std::vector<int>>() = ints;
+            return true;
+        }
+        case Type::String:{
+            std::string value;
+            if(!oscVariableArgs::asString(message, 0, value)) return false;
+            typed<std::string>() = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+ofEventListener oscChannel::listen(std::function<void()> changed) const{
+    switch(type){
+        case Type::Float: return typed<float>().newListener([changed](float &){changed();});
+        case Type::Int: return typed<int>().newListener([changed](int &){changed();});
+        case Type::FloatVector: return typed<std::vector<float>>().newListener([changed](std::vector<float> &){changed();});
+        case Type::IntVector: return typed<std::vector<int>>().newListener([changed](std::vector<int> &){changed();});
+        case Type::String: return typed<std::string>().newListener([changed](std::string &){changed();});
+    }
+    return ofEventListener();
+}
@@ -0,0 +1,61 @@
+//
+//  oscChannel.h
+//  ofxOceanodeOsc
+//
+//  Parameters of the Osc Sender and Osc Receiver nodes, compiled once from
+//  their configuration string "f:name:min:max, vf:..., i:..., vi:..., s:name".
+//  Every channel keeps its OSC address and clamp range, so sending or
+//  applying a value is a switch on the type and nothing else.
+//
+
+#ifndef oscChannel_h
+#define oscChannel_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+struct oscChannel {
+    enum class Type {
+        Float,
+        Int,
+        FloatVector,
+        IntVector,
+        String
+    };
+
+    Type type = Type::Float;
+    std::string address;    // "/node", or "/node/name"
+    float minFloat = 0;
+    float maxFloat = 0;
+    int minInt = 0;
+    int maxInt = 0;
+    std::shared_ptr<ofAbstractParameter> parameter;
+
+    // Unknown entries are skipped with a warning. A parameter named like the
+    // node is sent on the node's own address.
+    static std::vector<oscChannel> compile(const std::string &configuration, const std::string &nodeName);
+
+    // Current value, clamped, as a message to address
+    void encode(ofxOscMessage &message) const;
+    // Sets the parameter from a message, clamped. False if no argument fits the type.
+    bool decode(const ofxOscMessage &message) const;
+    // changed runs after every change of the parameter
+    ofEventListener listen(std::function<void()> changed) const;
+
+    // f(ofParameter<T>&) with the parameter at its own type, to add it to a node
+    template<typename F>
+    void visit(F f) const{
+        switch(type){
+            case Type::Float: f(typed<float>()); break;
+            case Type::Int: f(typed<int>()); break;
+            case Type::FloatVector: f(typed<std::vector<float>>()); break;
+            case Type::IntVector: f(typed<std::vector<int>>()); break;
+            case Type::String: f(typed<std::string>()); break;
+        }
+    }
+
+    template<typename T>
+    ofParameter<T> &typed() const {return static_cast<ofParameter<T>&>(*parameter);};
+};
+
+#endif /* oscChannel_h */
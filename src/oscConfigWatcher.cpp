@@ -0,0 +1,93 @@
+//
+//  oscConfigWatcher.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscConfigWatcher.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+oscConfigWatcher::~oscConfigWatcher(){
+    stop();
+}
+
+bool oscConfigWatcher::start(const std::string &_path){
+    stop();
+    path = _path;
+    size_t slash = path.find_last_of('/');
+    directory = slash == std::string::npos ? "." : path.substr(0, slash);
+    fileName = slash == std::string::npos ? path : path.substr(slash + 1);
+    lastModification = modificationTime();
+    lastPoll = ofGetElapsedTimeMillis();
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(fd < 0 || inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0){
+        ofLogWarning("oscConfigWatcher") << "inotify unavailable for " << directory << ": " << strerror(errno) << ", polling instead";
+        if(fd >= 0) ::close(fd);
+        fd = -1;
+    }
+#endif
+    watching = true;
+    return true;
+}
+
+void oscConfigWatcher::stop(){
+    if(fd >= 0){
+        ::close(fd);
+        fd = -1;
+    }
+    watching = false;
+}
+
+bool oscConfigWatcher::changed(){
+    if(!watching) return false;
+    if(fd >= 0) return readEvents();
+    uint64_t now = ofGetElapsedTimeMillis();
+    if(now - lastPoll < OSC_CONFIG_POLL_MS) return false;
+    lastPoll = now;
+    int64_t modification = modificationTime();
+    if(modification == lastModification) return false;
+    lastModification = modification;
+    return true;
+}
+
+void oscConfigWatcher::acknowledge(){
+    if(!watching) return;
+    if(fd >= 0) readEvents();
+    lastModification = modificationTime();
+    lastPoll = ofGetElapsedTimeMillis();
+}
+
+bool oscConfigWatcher::readEvents(){
+    bool matched = false;
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[4096];
+    ssize_t length;
+    while((length = ::read(fd, buffer, sizeof(buffer))) > 0){
+        for(ssize_t offset = 0; offset < length;){
+            auto event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            if(event->len > 0 && fileName == event->name) matched = true;
+            offset += sizeof(struct inotify_event) + event->len;
+        }
+    }
+#endif
+    return matched;
+}
+
+int64_t oscConfigWatcher::modificationTime() const{
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0) return 0;
+#ifdef __APPLE__
+    return int64_t(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+    return int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+}
@@ -0,0 +1,46 @@
+//
+//  oscConfigWatcher.h
+//  ofxOceanodeOsc
+//
+//  Tells the variables controller when oscVars.json changed on disk. On Linux
+//  the directory of the file is watched with inotify, since editors often
+//  save by writing a new file and renaming it over the old one. Elsewhere the
+//  modification time is checked twice a second. changed() never blocks.
+//
+
+#ifndef oscConfigWatcher_h
+#define oscConfigWatcher_h
+
+#include "ofMain.h"
+
+#define OSC_CONFIG_POLL_MS 500
+
+class oscConfigWatcher {
+public:
+    ~oscConfigWatcher();
+
+    bool start(const std::string &path);
+    void stop();
+    bool isWatching() const {return watching;};
+
+    // True once for every burst of changes since the last call
+    bool changed();
+    // Takes the file as it is now as seen, call it after writing the file
+    // ourselves so our own save is not reported as a change
+    void acknowledge();
+
+private:
+    int64_t modificationTime() const;
+    // Empties the inotify queue, true if any event was for our file
+    bool readEvents();
+
+    std::string path;
+    std::string directory;
+    std::string fileName;
+    bool watching = false;
+    int fd = -1;
+    int64_t lastModification = 0;
+    uint64_t lastPoll = 0;
+};
+
+#endif /* oscConfigWatcher_h */
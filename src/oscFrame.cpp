@@ -0,0 +1,93 @@
+//
+//  oscFrame.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscFrame.h"
+
+oscFrameInfo oscFrameInfo::fromMessage(const ofxOscMessage &message){
+    oscFrameInfo info;
+    if(message.getAddress() != OSC_FRAME_ADDRESS || message.getNumArgs() != 3) return info;
+    for(size_t i = 0; i < 3; i++){
+        if(message.getArgType(i) != OFXOSC_TYPE_INT32) return info;
+    }
+    info.framed = true;
+    info.stream = (uint32_t)message.getArgAsInt32(0);
+    info.frame = (uint32_t)message.getArgAsInt32(1);
+    info.messages = (uint32_t)message.getArgAsInt32(2);
+    return info;
+}
+
+ofxOscMessage oscFrameInfo::toMessage() const{
+    ofxOscMessage message;
+    message.setAddress(OSC_FRAME_ADDRESS);
+    message.addIntArg((int32_t)stream);
+    message.addIntArg((int32_t)frame);
+    message.addIntArg((int32_t)messages);
+    return message;
+}
+
+//-------------------------------------------------------------------------
+// oscFrameAssembler
+//-------------------------------------------------------------------------
+
+void oscFrameAssembler::add(ofxOscMessage &&message, const oscFrameInfo &info, std::deque<ofxOscMessage> &ready){
+    auto last = released.find(info.stream);
+    if(last != released.end() && int32_t(info.frame - last->second) <= 0) return;
+
+    Key key(info.stream, info.frame);
+    auto frame = pending.find(key);
+    if(frame == pending.end()){
+        if(pending.size() >= OSC_FRAME_MAX_PENDING){
+            release(pending.begin(), ready);
+            incomplete++;
+        }
+        frame = pending.emplace(key, Pending()).first;
+        frame->second.expected = info.messages;
+        frame->second.started = ofGetElapsedTimeMillis();
+    }
+    frame->second.messages.push_back(std::move(message));
+    if(frame->second.messages.size() < frame->second.expected) return;
+
+    // Older frames of the stream go first, so their values never land on top of this one
+    for(auto older = pending.lower_bound(Key(info.stream, 0)); older != frame;){
+        older = release(older, ready);
+        incomplete++;
+    }
+    release(frame, ready);
+    committed++;
+}
+
+void oscFrameAssembler::expire(uint64_t nowMs, std::deque<ofxOscMessage> &ready){
+    for(auto frame = pending.begin(); frame != pending.end();){
+        if(nowMs - frame->second.started > OSC_FRAME_TIMEOUT_MS){
+            frame = release(frame, ready);
+            incomplete++;
+        }else{
+            ++frame;
+        }
+    }
+}
+
+std::map<oscFrameAssembler::Key, oscFrameAssembler::Pending>::iterator oscFrameAssembler::release(std::map<Key, Pending>::iterator frame, std::deque<ofxOscMessage> &ready){
+    for(auto &message : frame->second.messages){
+        ready.push_back(std::move(message));
+    }
+    if(released.size() >= 64 && released.count(frame->first.first) == 0) released.clear();
+    released[frame->first.first] = frame->first.second;
+    return pending.erase(frame);
+}
+
+oscFrameStats oscFrameAssembler::getStats() const{
+    oscFrameStats stats;
+    stats.committed = committed;
+    stats.incomplete = incomplete;
+    return stats;
+}
+
+void oscFrameAssembler::reset(){
+    pending.clear();
+    released.clear();
+    committed = 0;
+    incomplete = 0;
+}
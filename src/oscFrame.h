@@ -0,0 +1,75 @@
+//
+//  oscFrame.h
+//  ofxOceanodeOsc
+//
+//  Opt-in framed mode. Every change a sender group makes in one frame travels
+//  in bundles that start with "/_frame ,iii <stream> <frame> <messages>",
+//  where messages is the size of the whole frame. Receivers hold the messages
+//  of a frame back until all of them arrived and then release the frame in one
+//  step, so values that belong together are never applied in different renders.
+//
+
+#ifndef oscFrame_h
+#define oscFrame_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+#include <deque>
+
+#define OSC_FRAME_ADDRESS "/_frame"
+// Incomplete frames are released with whatever arrived after this long
+#define OSC_FRAME_TIMEOUT_MS 100
+// Frames assembled at the same time, older ones are released early
+#define OSC_FRAME_MAX_PENDING 8
+
+// Frame header of one received packet
+struct oscFrameInfo {
+    bool framed = false;
+    uint32_t stream = 0;
+    uint32_t frame = 0;
+    uint32_t messages = 0;
+
+    static oscFrameInfo fromMessage(const ofxOscMessage &message);
+    ofxOscMessage toMessage() const;
+};
+
+struct oscFrameStats {
+    uint64_t committed = 0;     // Frames released complete
+    uint64_t incomplete = 0;    // Frames released after the timeout, or pushed out by newer ones
+};
+
+//-------------------------------------------------------------------------
+// oscFrameAssembler - Receiver side back buffer of partially received frames
+//
+// Not thread safe, the receiver calls it under its message lock.
+//-------------------------------------------------------------------------
+class oscFrameAssembler {
+public:
+    // Adds one message of a frame, complete frames are appended to ready
+    void add(ofxOscMessage &&message, const oscFrameInfo &info, std::deque<ofxOscMessage> &ready);
+    // Releases frames that waited longer than OSC_FRAME_TIMEOUT_MS
+    void expire(uint64_t nowMs, std::deque<ofxOscMessage> &ready);
+
+    oscFrameStats getStats() const;
+    void reset();
+
+private:
+    struct Pending {
+        uint32_t expected = 0;
+        uint64_t started = 0;
+        std::vector<ofxOscMessage> messages;
+    };
+    typedef std::pair<uint32_t, uint32_t> Key;    // stream, frame
+
+    std::map<Key, Pending>::iterator release(std::map<Key, Pending>::iterator frame, std::deque<ofxOscMessage> &ready);
+
+    std::map<Key, Pending> pending;
+    // Newest frame released per stream, late parts of it are stale
+    std::map<uint32_t, uint32_t> released;
+
+    std::atomic<uint64_t> committed{0};
+    std::atomic<uint64_t> incomplete{0};
+};
+
+#endif /* oscFrame_h */
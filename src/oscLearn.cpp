@@ -0,0 +1,117 @@
+//
+//  oscLearn.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscLearn.h"
+
+#include <cstring>
+
+oscLearnTable::oscLearnTable() : slots(new Slot[OSC_LEARN_CAPACITY]){
+}
+
+uint64_t oscLearnTable::hashAddress(const std::string &address){
+    // FNV-1a, 0 marks an empty slot so it is never returned
+    uint64_t hash = 14695981039346656037ull;
+    for(unsigned char c : address){
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash | 1;
+}
+
+void oscLearnTable::typeTagsOf(const ofxOscMessage &message, char *tags){
+    size_t count = std::min<size_t>(message.getNumArgs(), OSC_LEARN_MAX_TAGS);
+    for(size_t i = 0; i < count; i++){
+        tags[i] = char(message.getArgType(i));
+    }
+    tags[count] = 0;
+}
+
+void oscLearnTable::observe(const std::string &address, const ofxOscMessage &message){
+    if(address.size() >= OSC_LEARN_MAX_ADDRESS){
+        dropped++;
+        return;
+    }
+    uint64_t hash = hashAddress(address);
+    size_t index = hash & (OSC_LEARN_CAPACITY - 1);
+    for(size_t probe = 0; probe < OSC_LEARN_CAPACITY; probe++, index = (index + 1) & (OSC_LEARN_CAPACITY - 1)){
+        Slot &slot = slots[index];
+        uint64_t current = slot.hash.load(std::memory_order_acquire);
+        if(current == 0){
+            if(slot.hash.compare_exchange_strong(current, hash, std::memory_order_acq_rel)){
+                // Claimed, nobody else writes the address or the tags of this slot
+                memcpy(slot.address, address.c_str(), address.size() + 1);
+                typeTagsOf(message, slot.typeTags);
+                slot.maxArgs.store(message.getNumArgs(), std::memory_order_relaxed);
+                slot.count.fetch_add(1, std::memory_order_relaxed);
+                slot.ready.store(true, std::memory_order_release);
+                used++;
+                return;
+            }
+            // Lost the race, current now holds the winner's hash
+        }
+        if(current != hash) continue;
+        // Still being filled by its owner, count it without looking at it
+        if(!slot.ready.load(std::memory_order_acquire)){
+            slot.count.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if(address == slot.address){
+            update(slot, message);
+            return;
+        }
+    }
+    dropped++;
+}
+
+void oscLearnTable::update(Slot &slot, const ofxOscMessage &message){
+    slot.count.fetch_add(1, std::memory_order_relaxed);
+    uint32_t numArgs = message.getNumArgs();
+    uint32_t maxArgs = slot.maxArgs.load(std::memory_order_relaxed);
+    while(numArgs > maxArgs && !slot.maxArgs.compare_exchange_weak(maxArgs, numArgs, std::memory_order_relaxed)){}
+    if(!slot.mixed.load(std::memory_order_relaxed)){
+        char tags[OSC_LEARN_MAX_TAGS + 1];
+        typeTagsOf(message, tags);
+        // Vectors of another length are not a different type
+        size_t common = std::min(strlen(tags), strlen(slot.typeTags));
+        for(size_t i = 0; i < common; i++){
+            // True and false are one type with the value in the tag
+            bool booleans = (tags[i] == 'T' || tags[i] == 'F') && (slot.typeTags[i] == 'T' || slot.typeTags[i] == 'F');
+            if(tags[i] != slot.typeTags[i] && !booleans){
+                slot.mixed.store(true, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+}
+
+std::vector<oscLearnTable::Entry> oscLearnTable::getEntries() const{
+    std::vector<Entry> entries;
+    entries.reserve(used);
+    for(size_t i = 0; i < OSC_LEARN_CAPACITY; i++){
+        const Slot &slot = slots[i];
+        if(!slot.ready.load(std::memory_order_acquire)) continue;
+        Entry entry;
+        entry.address = slot.address;
+        entry.typeTags = slot.typeTags;
+        entry.maxArgs = slot.maxArgs.load(std::memory_order_relaxed);
+        entry.mixed = slot.mixed.load(std::memory_order_relaxed);
+        entry.count = slot.count.load(std::memory_order_relaxed);
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+void oscLearnTable::clear(){
+    for(size_t i = 0; i < OSC_LEARN_CAPACITY; i++){
+        Slot &slot = slots[i];
+        slot.ready.store(false, std::memory_order_relaxed);
+        slot.maxArgs.store(0, std::memory_order_relaxed);
+        slot.mixed.store(false, std::memory_order_relaxed);
+        slot.count.store(0, std::memory_order_relaxed);
+        slot.hash.store(0, std::memory_order_release);
+    }
+    used = 0;
+    dropped = 0;
+}
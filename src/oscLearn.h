@@ -0,0 +1,73 @@
+//
+//  oscLearn.h
+//  ofxOceanodeOsc
+//
+//  Learn mode of receiver groups. While it is on, every message for an
+//  address the group has no variable for is sampled into a fixed size open
+//  addressing table: the address, the type tags it first arrived with, the
+//  largest argument count seen and how many messages came in. The user can
+//  then create all of them as variables at once, with a type guessed from
+//  the tags (see oscVariableTypes::infer).
+//
+//  observe() never locks or allocates, a slot is claimed once with a CAS on
+//  its hash and only its counters change after that.
+//
+
+#ifndef oscLearn_h
+#define oscLearn_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+#include <atomic>
+
+// Distinct addresses learned at most, must be a power of two
+#define OSC_LEARN_CAPACITY 1024
+#define OSC_LEARN_MAX_ADDRESS 128
+#define OSC_LEARN_MAX_TAGS 32
+
+class oscLearnTable {
+public:
+    struct Entry {
+        std::string address;
+        std::string typeTags;       // Of the first message seen
+        uint32_t maxArgs = 0;
+        bool mixed = false;         // Later messages had other type tags
+        uint64_t count = 0;
+    };
+
+    oscLearnTable();
+
+    // Safe from any thread. Addresses past the capacity, or too long to keep,
+    // are only counted as dropped.
+    void observe(const std::string &address, const ofxOscMessage &message);
+
+    // Complete entries in slot order
+    std::vector<Entry> getEntries() const;
+    size_t size() const {return used;};
+    uint64_t getDropped() const {return dropped;};
+
+    // Not safe while another thread is in observe()
+    void clear();
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> hash{0};
+        std::atomic<bool> ready{false};
+        char address[OSC_LEARN_MAX_ADDRESS];
+        char typeTags[OSC_LEARN_MAX_TAGS + 1];
+        std::atomic<uint32_t> maxArgs{0};
+        std::atomic<bool> mixed{false};
+        std::atomic<uint64_t> count{0};
+    };
+
+    static uint64_t hashAddress(const std::string &address);
+    static void typeTagsOf(const ofxOscMessage &message, char *tags);
+    void update(Slot &slot, const ofxOscMessage &message);
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<size_t> used{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+#endif /* oscLearn_h */
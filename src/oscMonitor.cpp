@@ -0,0 +1,108 @@
+//
+//  oscMonitor.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscMonitor.h"
+#include "oscQuantize.h"
+
+#include <chrono>
+#include <cmath>
+
+oscVariableMonitor::oscVariableMonitor() : slots(new Slot[OSC_MONITOR_CAPACITY]){
+}
+
+void oscVariableMonitor::record(const ofxOscMessage &message){
+    uint64_t time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    float sum = 0, min = 0, max = 0;
+    uint32_t size = 0;
+    auto add = [&](float value){
+        min = size == 0 ? value : std::min(min, value);
+        max = size == 0 ? value : std::max(max, value);
+        sum += value;
+        size++;
+    };
+    // Quantized float vectors carry a single blob, see oscQuantize.h
+    static thread_local std::vector<float> quantized;
+    if(message.getNumArgs() == 1 && message.getArgType(0) == OFXOSC_TYPE_BLOB){
+        const ofBuffer &blob = message.getArgAsBlob(0);
+        if(oscQuantizer::decode(blob.getData(), blob.size(), quantized)){
+            for(float value : quantized) add(value);
+        }
+    }
+    for(size_t i = 0; i < message.getNumArgs(); i++){
+        float value;
+        switch(message.getArgType(i)){
+            case OFXOSC_TYPE_FLOAT:
+            case OFXOSC_TYPE_DOUBLE:
+            case OFXOSC_TYPE_INT32:
+            case OFXOSC_TYPE_INT64:
+                value = message.getArgAsFloat(i);
+                break;
+            case OFXOSC_TYPE_TRUE: value = 1; break;
+            case OFXOSC_TYPE_FALSE: value = 0; break;
+            default: continue;
+        }
+        add(value);
+    }
+
+    uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[index & (OSC_MONITOR_CAPACITY - 1)];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.time.store(time, std::memory_order_relaxed);
+    slot.mean.store(size > 0 ? sum / size : 0, std::memory_order_relaxed);
+    slot.min.store(min, std::memory_order_relaxed);
+    slot.max.store(max, std::memory_order_relaxed);
+    slot.size.store(size, std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void oscVariableMonitor::getSamples(std::vector<Sample> &samples) const{
+    samples.clear();
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t begin = end > OSC_MONITOR_CAPACITY ? end - OSC_MONITOR_CAPACITY : 0;
+    samples.reserve(end - begin);
+    for(uint64_t index = begin; index < end; index++){
+        const Slot &slot = slots[index & (OSC_MONITOR_CAPACITY - 1)];
+        if(slot.sequence.load(std::memory_order_acquire) != index + 1) continue;
+        Sample sample;
+        sample.time = slot.time.load(std::memory_order_relaxed);
+        sample.mean = slot.mean.load(std::memory_order_relaxed);
+        sample.min = slot.min.load(std::memory_order_relaxed);
+        sample.max = slot.max.load(std::memory_order_relaxed);
+        sample.size = slot.size.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Overwritten while we read it
+        if(slot.sequence.load(std::memory_order_relaxed) != index + 1) continue;
+        samples.push_back(sample);
+    }
+}
+
+oscVariableMonitor::Summary oscVariableMonitor::summarize(const std::vector<Sample> &samples){
+    Summary summary;
+    summary.samples = samples.size();
+    if(samples.empty()) return summary;
+
+    bool numeric = false;
+    for(auto &sample : samples){
+        if(sample.size == 0) continue;
+        summary.min = numeric ? std::min(summary.min, sample.min) : sample.min;
+        summary.max = numeric ? std::max(summary.max, sample.max) : sample.max;
+        numeric = true;
+    }
+
+    if(samples.size() < 2) return summary;
+    double span = (samples.back().time - samples.front().time) / 1000.0;
+    size_t intervals = samples.size() - 1;
+    if(span > 0) summary.rate = intervals * 1000.0 / span;
+    summary.meanInterval = span / intervals;
+    double variance = 0;
+    for(size_t i = 1; i < samples.size(); i++){
+        double interval = (samples[i].time - samples[i - 1].time) / 1000.0 - summary.meanInterval;
+        variance += interval * interval;
+    }
+    summary.jitter = std::sqrt(variance / intervals);
+    return summary;
+}
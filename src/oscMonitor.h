@@ -0,0 +1,68 @@
+//
+//  oscMonitor.h
+//  ofxOceanodeOsc
+//
+//  History of the messages of one variable for the controller panel: when each
+//  was sent or received and the mean, min and max of its numeric arguments.
+//  Samples go to a fixed ring that record() claims slots in with one atomic
+//  add, so the receive thread never waits on the panel. Each slot carries a
+//  sequence number, readers skip the ones being overwritten while they copy.
+//
+
+#ifndef oscMonitor_h
+#define oscMonitor_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+#include <atomic>
+
+// Samples kept per monitored variable, a power of two
+#define OSC_MONITOR_CAPACITY 512
+
+class oscVariableMonitor {
+public:
+    struct Sample {
+        uint64_t time = 0;      // Microseconds, steady clock
+        float mean = 0;
+        float min = 0;
+        float max = 0;
+        uint32_t size = 0;      // Numeric arguments, 0 for strings
+    };
+
+    // Rate and inter-arrival times over the samples held
+    struct Summary {
+        size_t samples = 0;
+        float rate = 0;         // Messages per second
+        float meanInterval = 0; // Milliseconds
+        float jitter = 0;       // Standard deviation of the interval, milliseconds
+        float min = 0;
+        float max = 0;
+    };
+
+    oscVariableMonitor();
+
+    // Any thread, never blocks
+    void record(const ofxOscMessage &message);
+
+    // Copies the samples held, oldest first
+    void getSamples(std::vector<Sample> &samples) const;
+    uint64_t getCount() const {return head.load(std::memory_order_relaxed);};
+
+    static Summary summarize(const std::vector<Sample> &samples);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};  // Index + 1 once written, 0 while being written
+        std::atomic<uint64_t> time{0};
+        std::atomic<float> mean{0};
+        std::atomic<float> min{0};
+        std::atomic<float> max{0};
+        std::atomic<uint32_t> size{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head{0};
+};
+
+#endif /* oscMonitor_h */
@@ -0,0 +1,123 @@
+//
+//  oscQuantize.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscQuantize.h"
+
+#include <cstring>
+
+// The kernels are straight loops over typed arrays with no branches, the
+// clamp is min/max and rounding a biased truncation, so the compiler turns
+// them into SIMD code. Steps are staged in a per thread array and copied to or
+// from the blob in one block, the blob itself is never accessed as Step.
+
+// t = (value - offset) / scale clamped to lo..hi, step = int(t + shift + 0.5) - shift
+template<typename Step>
+static void quantize(const std::vector<float> &values, float offset, float inverse, float lo, float hi, int32_t shift, char *out){
+    static thread_local std::vector<Step> steps;
+    steps.resize(values.size());
+    const float *in = values.data();
+    Step *step = steps.data();
+    const float bias = float(shift) + 0.5f;
+    for(size_t i = 0; i < values.size(); i++){
+        // NaN ends up at hi
+        float t = std::max(lo, std::min(hi, (in[i] - offset) * inverse));
+        step[i] = Step(int32_t(t + bias) - shift);
+    }
+    memcpy(out, steps.data(), steps.size() * sizeof(Step));
+}
+
+template<typename Step>
+static void dequantize(const char *in, size_t count, float offset, float scale, float *values){
+    static thread_local std::vector<Step> steps;
+    steps.resize(count);
+    memcpy(steps.data(), in, count * sizeof(Step));
+    const Step *step = steps.data();
+    for(size_t i = 0; i < count; i++){
+        values[i] = offset + float(step[i]) * scale;
+    }
+}
+
+static size_t stepSize(oscQuantization format){
+    switch(format){
+        case oscQuantization::Uint8: return 1;
+        case oscQuantization::Uint16:
+        case oscQuantization::Int16: return 2;
+        case oscQuantization::None: break;
+    }
+    return 0;
+}
+
+void oscQuantizer::encode(const std::vector<float> &values, ofxOscMessage &message) const{
+    // Reused by every vector encoded on this thread
+    static thread_local std::vector<char> blob;
+
+    float lo = 0, hi = 0, offset = min, scale = 0;
+    int32_t shift = 0;
+    switch(format){
+        case oscQuantization::Uint8: hi = 255; break;
+        case oscQuantization::Uint16: hi = 65535; break;
+        case oscQuantization::Int16: lo = -32767; hi = 32767; shift = 32767; offset = (min + max) / 2; break;
+        case oscQuantization::None: break;
+    }
+    // An empty range sends every value as min
+    if(max > min) scale = (max - min) / (hi - lo);
+    float inverse = scale > 0 ? 1 / scale : 0;
+
+    blob.resize(OSC_QUANTIZED_HEADER_SIZE + values.size() * stepSize(format));
+    char *data = blob.data();
+    data[0] = OSC_QUANTIZED_MAGIC;
+    data[1] = char(format);
+    data[2] = data[3] = 0;
+    memcpy(data + 4, &scale, 4);
+    memcpy(data + 8, &offset, 4);
+    char *steps = data + OSC_QUANTIZED_HEADER_SIZE;
+    switch(format){
+        case oscQuantization::Uint8: quantize<uint8_t>(values, offset, inverse, lo, hi, shift, steps); break;
+        case oscQuantization::Uint16: quantize<uint16_t>(values, offset, inverse, lo, hi, shift, steps); break;
+        case oscQuantization::Int16: quantize<int16_t>(values, offset, inverse, lo, hi, shift, steps); break;
+        case oscQuantization::None: break;
+    }
+
+    message.addBlobArg(ofBuffer(blob.data(), blob.size()));
+}
+
+bool oscQuantizer::decode(const char *blob, size_t size, std::vector<float> &values){
+    if(size < OSC_QUANTIZED_HEADER_SIZE || blob[0] != OSC_QUANTIZED_MAGIC) return false;
+    oscQuantization format = oscQuantization(uint8_t(blob[1]));
+    size_t step = stepSize(format);
+    if(step == 0 || (size - OSC_QUANTIZED_HEADER_SIZE) % step != 0) return false;
+
+    float scale, offset;
+    memcpy(&scale, blob + 4, 4);
+    memcpy(&offset, blob + 8, 4);
+    size_t count = (size - OSC_QUANTIZED_HEADER_SIZE) / step;
+    const char *steps = blob + OSC_QUANTIZED_HEADER_SIZE;
+    // Same size as the last message keeps the storage
+    values.resize(count);
+    switch(format){
+        case oscQuantization::Uint8: dequantize<uint8_t>(steps, count, offset, scale, values.data()); break;
+        case oscQuantization::Uint16: dequantize<uint16_t>(steps, count, offset, scale, values.data()); break;
+        case oscQuantization::Int16: dequantize<int16_t>(steps, count, offset, scale, values.data()); break;
+        case oscQuantization::None: break;
+    }
+    return true;
+}
+
+const char *oscQuantizer::toString(oscQuantization format){
+    switch(format){
+        case oscQuantization::Uint8: return "uint8";
+        case oscQuantization::Uint16: return "uint16";
+        case oscQuantization::Int16: return "int16";
+        case oscQuantization::None: break;
+    }
+    return "none";
+}
+
+oscQuantization oscQuantizer::fromString(const std::string &name){
+    if(name == "uint8") return oscQuantization::Uint8;
+    if(name == "uint16") return oscQuantization::Uint16;
+    if(name == "int16") return oscQuantization::Int16;
+    return oscQuantization::None;
+}
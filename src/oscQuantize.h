@@ -0,0 +1,53 @@
+//
+//  oscQuantize.h
+//  ofxOceanodeOsc
+//
+//  Compact wire formats for float vectors. Each element is stored as a uint8,
+//  uint16 or int16 step of a range, so normalized data travels in a quarter or
+//  half of the bytes, without a type tag per element. The message carries one
+//  blob that describes itself, receivers need no settings to read it:
+//
+//  Layout: 'Q' | u8 format | u16 reserved | f32 scale | f32 offset | elements
+//
+//  value = offset + step * scale. Everything in the blob is little endian.
+//
+
+#ifndef oscQuantize_h
+#define oscQuantize_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#error "Quantized vectors are written in host byte order, which must be little endian"
+#endif
+
+#define OSC_QUANTIZED_MAGIC 'Q'
+#define OSC_QUANTIZED_HEADER_SIZE 12
+
+enum class oscQuantization {
+    None,
+    Uint8,      // 0..255 over min..max
+    Uint16,     // 0..65535 over min..max
+    Int16       // -32767..32767 over min..max, the middle of the range is exact
+};
+
+struct oscQuantizer {
+    oscQuantization format = oscQuantization::None;
+    // Range sent without loss of resolution, values outside are clamped
+    float min = 0;
+    float max = 1;
+
+    bool isEnabled() const {return format != oscQuantization::None;};
+
+    // Adds the blob to message, as its only argument when message has none
+    void encode(const std::vector<float> &values, ofxOscMessage &message) const;
+    // False if blob is not a quantized vector, values is left as it was then
+    static bool decode(const char *blob, size_t size, std::vector<float> &values);
+
+    // As saved in oscVars.json
+    static const char *toString(oscQuantization format);
+    static oscQuantization fromString(const std::string &name);
+};
+
+#endif /* oscQuantize_h */
@@ -0,0 +1,52 @@
+//
+//  oscReceiver.h
+//  ofxOceanodeOsc
+//
+//  Counterpart of oscSender: the same configuration string, with the values
+//  coming in on the OSC controller's receiver port instead of going out.
+//
+
+#ifndef oscReceiver_h
+#define oscReceiver_h
+
+#include "ofxOceanodeNodeModel.h"
+#include "ofxOsc.h"
+#include "ofxOceanodeOSCController.h"
+#include "oscChannel.h"
+
+class oscReceiver : public ofxOceanodeNodeModel{
+public:
+    oscReceiver(string name, string config, shared_ptr<ofxOceanodeOSCController> _controller) : additionalName(name), configuration(config), controller(_controller), ofxOceanodeNodeModel("Osc Receiver " + name){
+    };
+
+    ~oscReceiver(){
+        controller->removeReceiverRoutes(this);
+    }
+
+    void setup(){
+        // "f:name:min:max, vf:name:min:max, i:..., vi:..., s:name", see oscChannel.h
+        channels = oscChannel::compile(configuration, additionalName);
+        for(size_t index = 0; index < channels.size(); index++){
+            channels[index].visit([this](auto &parameter){addParameter(parameter);});
+            channelIndex[channels[index].address] = index;
+        }
+
+        // One route for the whole node, the controller shares its socket with every receiver
+        controller->addReceiverRoute(additionalName, this, [this](const ofxOscMessage &message){
+            auto channel = channelIndex.find(message.getAddress());
+            if(channel != channelIndex.end()){
+                channels[channel->second].decode(message);
+            }
+        });
+    }
+
+private:
+    string additionalName;
+    string configuration;
+    shared_ptr<ofxOceanodeOSCController> controller;
+
+    vector<oscChannel> channels;
+    std::unordered_map<string, size_t> channelIndex;
+};
+
+#endif /* oscReceiver_h */
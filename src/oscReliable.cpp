@@ -0,0 +1,144 @@
+//
+//  oscReliable.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscReliable.h"
+
+#include <cstring>
+
+//-------------------------------------------------------------------------
+// oscRetransmitBuffer
+//-------------------------------------------------------------------------
+
+void oscRetransmitBuffer::allocate(size_t slots, size_t _slotSize){
+    slotSize = _slotSize;
+    arena.assign(slots * slotSize, 0);
+    sequences.assign(slots, 0);
+    sizes.assign(slots, 0);
+}
+
+bool oscRetransmitBuffer::store(uint32_t sequence, const char *data, size_t size){
+    if(!isAllocated()) allocate();
+    size_t slot = sequence % sequences.size();
+    sequences[slot] = sequence;
+    if(size > slotSize){
+        sizes[slot] = 0;
+        return false;
+    }
+    memcpy(arena.data() + slot * slotSize, data, size);
+    sizes[slot] = size;
+    return true;
+}
+
+bool oscRetransmitBuffer::find(uint32_t sequence, const char *&data, size_t &size) const{
+    if(!isAllocated()) return false;
+    size_t slot = sequence % sequences.size();
+    if(sequences[slot] != sequence || sizes[slot] == 0) return false;
+    data = arena.data() + slot * slotSize;
+    size = sizes[slot];
+    return true;
+}
+
+//-------------------------------------------------------------------------
+// oscReliableTracker
+//-------------------------------------------------------------------------
+
+void oscReliableTracker::markMissing(Stream &stream, uint32_t upTo){
+    // Only the most recent gap is worth asking for if the sender ran far ahead
+    uint32_t first = stream.highest + 1;
+    if(int32_t(upTo - first) >= OSC_RELIABLE_MAX_MISSING){
+        unrecoverable += (upTo - first) - OSC_RELIABLE_MAX_MISSING;
+        first = upTo - OSC_RELIABLE_MAX_MISSING;
+    }
+    for(uint32_t sequence = first; sequence != upTo; sequence++){
+        stream.missing[sequence];
+    }
+    while(stream.missing.size() > OSC_RELIABLE_MAX_MISSING){
+        stream.missing.erase(stream.missing.begin());
+        unrecoverable++;
+    }
+}
+
+bool oscReliableTracker::track(const oscSequenceInfo &info){
+    auto existing = streams.find(info.stream);
+    if(existing == streams.end()){
+        if(streams.size() >= OSC_SEQUENCE_MAX_STREAMS){
+            streams.clear();
+            appliedSequences.clear();
+        }
+        // Joined mid stream, history before this point is not requested
+        Stream &stream = streams[info.stream];
+        stream.highest = info.sequence;
+        return !info.heartbeat;
+    }
+
+    Stream &stream = existing->second;
+    int32_t distance = int32_t(info.sequence - stream.highest);
+    if(info.heartbeat){
+        // Heartbeats announce the latest sequence sent, catching lost tails
+        if(distance > 0){
+            markMissing(stream, info.sequence + 1);
+            stream.highest = info.sequence;
+        }
+        return false;
+    }
+    if(distance > 0){
+        markMissing(stream, info.sequence);
+        stream.highest = info.sequence;
+        return true;
+    }
+    auto missing = stream.missing.find(info.sequence);
+    if(missing != stream.missing.end()){
+        stream.missing.erase(missing);
+        recovered++;
+        return true;
+    }
+    return false;
+}
+
+bool oscReliableTracker::shouldApply(const std::string &address, const oscSequenceInfo &info){
+    auto applied = appliedSequences.emplace(std::make_pair(info.stream, address), info.sequence);
+    if(applied.second) return true;
+    if(int32_t(info.sequence - applied.first->second) <= 0) return false;
+    applied.first->second = info.sequence;
+    return true;
+}
+
+void oscReliableTracker::collectNacks(uint64_t nowMs, std::map<uint32_t, std::vector<uint32_t>> &nacks){
+    for(auto &stream : streams){
+        for(auto it = stream.second.missing.begin(); it != stream.second.missing.end();){
+            Missing &missing = it->second;
+            if(missing.attempts > 0 && nowMs - missing.lastRequest < OSC_RELIABLE_RETRY_MS){
+                ++it;
+                continue;
+            }
+            if(missing.attempts >= OSC_RELIABLE_MAX_ATTEMPTS){
+                unrecoverable++;
+                it = stream.second.missing.erase(it);
+                continue;
+            }
+            missing.attempts++;
+            missing.lastRequest = nowMs;
+            nacks[stream.first].push_back(it->first);
+            ++it;
+        }
+    }
+    if(!nacks.empty()) nacksSent++;
+}
+
+oscReliableStats oscReliableTracker::getStats() const{
+    oscReliableStats stats;
+    stats.nacksSent = nacksSent;
+    stats.recovered = recovered;
+    stats.unrecoverable = unrecoverable;
+    return stats;
+}
+
+void oscReliableTracker::reset(){
+    streams.clear();
+    appliedSequences.clear();
+    nacksSent = 0;
+    recovered = 0;
+    unrecoverable = 0;
+}
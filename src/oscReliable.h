@@ -0,0 +1,102 @@
+//
+//  oscReliable.h
+//  ofxOceanodeOsc
+//
+//  Selective NACK retransmission for variables flagged as reliable.
+//
+//  Reliable packets carry "/_rseq ,ii <stream> <sequence>" as their first
+//  element, on a stream separate from the "/_seq" one so unreliable traffic
+//  is never delayed or retransmitted. Senders keep the last packets in a fixed
+//  ring and periodically announce their latest sequence with "/_rhb ,ii".
+//  Receivers answer gaps with "/_nack ,ii... <stream> <sequence>..." sent back
+//  to the source address of the packets, and the sender resends only those.
+//
+
+#ifndef oscReliable_h
+#define oscReliable_h
+
+#include "ofMain.h"
+#include "oscSequence.h"
+
+#define OSC_RELIABLE_ADDRESS "/_rseq"
+#define OSC_HEARTBEAT_ADDRESS "/_rhb"
+#define OSC_NACK_ADDRESS "/_nack"
+
+// Packets kept for retransmission, and the largest packet kept
+#define OSC_RETRANSMIT_SLOTS 256
+#define OSC_RETRANSMIT_SLOT_SIZE 2048
+// Missing sequences requested per stream, and how often each one is asked for
+#define OSC_RELIABLE_MAX_MISSING 256
+#define OSC_RELIABLE_MAX_ATTEMPTS 5
+#define OSC_RELIABLE_RETRY_MS 50
+#define OSC_RELIABLE_HEARTBEAT_MS 250
+
+//-------------------------------------------------------------------------
+// oscRetransmitBuffer - Sender side ring of recent reliable packets
+//
+// The arena is allocated once, on the first reliable send, so groups without
+// reliable variables never pay for it.
+//-------------------------------------------------------------------------
+class oscRetransmitBuffer {
+public:
+    void allocate(size_t slots = OSC_RETRANSMIT_SLOTS, size_t slotSize = OSC_RETRANSMIT_SLOT_SIZE);
+    bool isAllocated() const {return !arena.empty();};
+
+    // Packets bigger than a slot are not kept
+    bool store(uint32_t sequence, const char *data, size_t size);
+    bool find(uint32_t sequence, const char *&data, size_t &size) const;
+
+private:
+    std::vector<char> arena;
+    std::vector<uint32_t> sequences;
+    std::vector<uint32_t> sizes;
+    size_t slotSize = 0;
+};
+
+struct oscReliableStats {
+    uint64_t nacksSent = 0;
+    uint64_t recovered = 0;       // Missing packets that arrived after a NACK
+    uint64_t unrecoverable = 0;   // Missing packets given up on
+};
+
+//-------------------------------------------------------------------------
+// oscReliableTracker - Receiver side gap tracking and NACK scheduling
+//
+// Only touched by the receiving thread, counters are atomic for the panel.
+//-------------------------------------------------------------------------
+class oscReliableTracker {
+public:
+    // Returns false for duplicates
+    bool track(const oscSequenceInfo &info);
+    // Retransmitted packets must not overwrite newer values of the same address.
+    // Compared within the packet's stream only, a restarted sender starts over.
+    bool shouldApply(const std::string &address, const oscSequenceInfo &info);
+
+    // Sequences due for a (re)request, grouped by stream
+    void collectNacks(uint64_t nowMs, std::map<uint32_t, std::vector<uint32_t>> &nacks);
+
+    oscReliableStats getStats() const;
+    void reset();
+
+private:
+    struct Missing {
+        uint64_t lastRequest = 0;
+        int attempts = 0;
+    };
+    struct Stream {
+        uint32_t highest = 0;
+        std::map<uint32_t, Missing> missing;
+    };
+
+    void markMissing(Stream &stream, uint32_t upTo);
+
+    // Both forgotten together past OSC_SEQUENCE_MAX_STREAMS streams
+    std::map<uint32_t, Stream> streams;
+    std::map<std::pair<uint32_t, std::string>, uint32_t> appliedSequences;
+
+    std::atomic<uint64_t> nacksSent{0};
+    std::atomic<uint64_t> recovered{0};
+    std::atomic<uint64_t> unrecoverable{0};
+};
+
+#endif /* oscReliable_h */
@@ -0,0 +1,126 @@
+//
+//  oscResolver.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscResolver.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#include <cstring>
+
+oscResolver &oscResolver::shared(){
+    static oscResolver resolver;
+    return resolver;
+}
+
+oscResolver::~oscResolver(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    condition.notify_one();
+    if(thread.joinable()){
+        thread.join();
+    }
+}
+
+oscResolver::Status oscResolver::lookup(const std::string &host, in_addr &address, std::string *error){
+    if(inet_pton(AF_INET, host.c_str(), &address) == 1){
+        return Status::Resolved;
+    }
+    if(host == "localhost"){
+        address.s_addr = htonl(INADDR_LOOPBACK);
+        return Status::Resolved;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Cached &cached = cache[host];
+    uint64_t now = ofGetElapsedTimeMillis();
+    if(cached.updated == 0){
+        queue(host, cached);
+        return Status::Pending;
+    }
+    if(cached.resolved){
+        if(now - cached.updated >= OSC_RESOLVER_TTL_MS) queue(host, cached);
+        address = cached.address;
+        return Status::Resolved;
+    }
+    if(now - cached.updated >= OSC_RESOLVER_RETRY_MS) queue(host, cached);
+    if(error != nullptr) *error = cached.error;
+    return Status::Failed;
+}
+
+void oscResolver::queue(const std::string &host, Cached &cached){
+    if(cached.queued) return;
+    cached.queued = true;
+    pending.push_back(host);
+    if(!running){
+        running = true;
+        thread = std::thread(&oscResolver::threadedFunction, this);
+    }
+    condition.notify_one();
+}
+
+void oscResolver::threadedFunction(){
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true){
+        condition.wait(lock, [this]{return !pending.empty() || !running;});
+        if(!running) break;
+        std::string host = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo *result = nullptr;
+        int status = getaddrinfo(host.c_str(), nullptr, &hints, &result);
+        in_addr address;
+        if(status == 0 && result != nullptr){
+            address = reinterpret_cast<sockaddr_in*>(result->ai_addr)->sin_addr;
+        }
+        if(result != nullptr) freeaddrinfo(result);
+
+        lock.lock();
+        Cached &cached = cache[host];
+        cached.queued = false;
+        cached.updated = std::max<uint64_t>(ofGetElapsedTimeMillis(), 1);
+        if(status == 0){
+            cached.resolved = true;
+            cached.address = address;
+            cached.error.clear();
+        }else{
+            // A refresh that fails keeps the address we had
+            cached.error = gai_strerror(status);
+            ofLogWarning("oscResolver") << "Could not resolve " << host << ": " << cached.error;
+        }
+    }
+}
+
+std::vector<oscResolver::Entry> oscResolver::getEntries() const{
+    std::vector<Entry> entries;
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t now = ofGetElapsedTimeMillis();
+    for(auto &cached : cache){
+        Entry entry;
+        entry.host = cached.first;
+        entry.error = cached.second.error;
+        if(cached.second.updated == 0){
+            entry.status = Status::Pending;
+        }else{
+            entry.status = cached.second.resolved ? Status::Resolved : Status::Failed;
+            entry.age = now - cached.second.updated;
+        }
+        if(cached.second.resolved){
+            char numeric[INET_ADDRSTRLEN];
+            inet_ntop(AF_INET, &cached.second.address, numeric, sizeof(numeric));
+            entry.address = numeric;
+        }
+        entries.push_back(entry);
+    }
+    return entries;
+}
@@ -0,0 +1,75 @@
+//
+//  oscResolver.h
+//  ofxOceanodeOsc
+//
+//  Host name lookups off the main thread. lookup() only ever reads a cache:
+//  names it has not seen are queued for a background thread and reported as
+//  pending, callers ask again later. Addresses are kept for OSC_RESOLVER_TTL_MS
+//  and then refreshed in the background while the old one is still handed
+//  out, so a slow resolver never stops traffic to a host that already works.
+//  Failed names are retried every OSC_RESOLVER_RETRY_MS.
+//
+
+#ifndef oscResolver_h
+#define oscResolver_h
+
+#include "ofMain.h"
+
+#include <netinet/in.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#define OSC_RESOLVER_TTL_MS 60000
+#define OSC_RESOLVER_RETRY_MS 5000
+
+class oscResolver {
+public:
+    enum class Status {
+        Pending,
+        Resolved,
+        Failed
+    };
+
+    struct Entry {
+        std::string host;
+        Status status = Status::Pending;
+        std::string address;    // Numeric, empty until first resolved
+        std::string error;      // Last failure, kept while an older address is still used
+        uint64_t age = 0;       // Milliseconds since the last answer
+    };
+
+    // Shared by every sender in the process
+    static oscResolver &shared();
+    ~oscResolver();
+
+    // Never blocks. Numeric addresses and localhost are answered in place.
+    Status lookup(const std::string &host, in_addr &address, std::string *error = nullptr);
+
+    // Every name looked up so far, for the controller panel
+    std::vector<Entry> getEntries() const;
+
+private:
+    struct Cached {
+        bool resolved = false;  // address holds a usable answer, maybe an expired one
+        in_addr address;
+        std::string error;
+        uint64_t updated = 0;
+        bool queued = false;
+    };
+
+    oscResolver() = default;
+    void queue(const std::string &host, Cached &cached);
+    void threadedFunction();
+
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    std::map<std::string, Cached> cache;
+    std::deque<std::string> pending;
+    std::thread thread;
+    bool running = false;
+};
+
+#endif /* oscResolver_h */
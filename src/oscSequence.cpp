@@ -0,0 +1,86 @@
+//
+//  oscSequence.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscSequence.h"
+#include "oscReliable.h"
+
+oscSequenceInfo oscSequenceInfo::fromMessage(const ofxOscMessage &message){
+    oscSequenceInfo info;
+    const std::string &address = message.getAddress();
+    if(address.size() < 4 || address[1] != '_' ||
+       message.getNumArgs() != 2 ||
+       message.getArgType(0) != OFXOSC_TYPE_INT32 ||
+       message.getArgType(1) != OFXOSC_TYPE_INT32){
+        return info;
+    }
+    info.reliable = (address == OSC_RELIABLE_ADDRESS);
+    info.heartbeat = (address == OSC_HEARTBEAT_ADDRESS);
+    info.sequenced = info.reliable || info.heartbeat || address == OSC_SEQUENCE_ADDRESS;
+    info.reliable |= info.heartbeat;
+    if(info.sequenced){
+        info.stream = (uint32_t)message.getArgAsInt32(0);
+        info.sequence = (uint32_t)message.getArgAsInt32(1);
+    }
+    return info;
+}
+
+const char *oscSequenceInfo::getAddress() const{
+    if(heartbeat) return OSC_HEARTBEAT_ADDRESS;
+    if(reliable) return OSC_RELIABLE_ADDRESS;
+    return OSC_SEQUENCE_ADDRESS;
+}
+
+oscSequenceTracker::Verdict oscSequenceTracker::track(const oscSequenceInfo &info){
+    if(!info.sequenced) return Verdict::Accept;
+
+    auto existing = streams.find(info.stream);
+    if(existing == streams.end()){
+        if(streams.size() >= OSC_SEQUENCE_MAX_STREAMS) streams.clear();
+        Stream &stream = streams[info.stream];
+        stream.highest = info.sequence;
+        stream.window = 1;
+        packets++;
+        return Verdict::Accept;
+    }else{
+        Stream &stream = existing->second;
+        // Signed distance handles the 32 bit wrap around
+        int32_t distance = int32_t(info.sequence - stream.highest);
+        if(distance > 0){
+            lost += distance - 1;
+            stream.window = (distance >= 64) ? 1 : (stream.window << distance) | 1;
+            stream.highest = info.sequence;
+            packets++;
+            return Verdict::Accept;
+        }else if(distance > -64 && (stream.window & (uint64_t(1) << -distance))){
+            duplicates++;
+            return Verdict::Duplicate;
+        }else{
+            // Arrived after newer data was applied, it was counted as lost when the gap opened
+            if(distance > -64){
+                stream.window |= uint64_t(1) << -distance;
+                if(lost > 0) lost--;
+            }
+            reordered++;
+            return Verdict::Late;
+        }
+    }
+}
+
+oscSequenceStats oscSequenceTracker::getStats() const{
+    oscSequenceStats stats;
+    stats.packets = packets;
+    stats.lost = lost;
+    stats.reordered = reordered;
+    stats.duplicates = duplicates;
+    return stats;
+}
+
+void oscSequenceTracker::reset(){
+    streams.clear();
+    packets = 0;
+    lost = 0;
+    reordered = 0;
+    duplicates = 0;
+}
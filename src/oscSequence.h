@@ -0,0 +1,77 @@
+//
+//  oscSequence.h
+//  ofxOceanodeOsc
+//
+//  Optional sequencing of OSC packets. A sequenced packet is a bundle whose
+//  first element is "/_seq ,ii <stream> <sequence>". The stream id is random
+//  per sender setup, so a restarted sender starts a fresh stream. Receivers
+//  that do not know about sequencing just see an unknown address.
+//
+
+#ifndef oscSequence_h
+#define oscSequence_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+#define OSC_SEQUENCE_ADDRESS "/_seq"
+// Streams kept per tracker, older ones are forgotten when senders restart a lot
+#define OSC_SEQUENCE_MAX_STREAMS 64
+
+struct oscSequenceStats {
+    uint64_t packets = 0;       // Accepted sequenced packets
+    uint64_t lost = 0;          // Sequence numbers never seen
+    uint64_t reordered = 0;     // Late packets, discarded because newer data was applied
+    uint64_t duplicates = 0;    // Packets seen twice, discarded
+
+    float lossRate() const {return packets + lost == 0 ? 0 : float(lost) / float(packets + lost);};
+    float reorderRate() const {return packets == 0 ? 0 : float(reordered) / float(packets);};
+};
+
+// Sequence header of one received packet
+struct oscSequenceInfo {
+    bool sequenced = false;
+    bool reliable = false;    // "/_rseq" header, see oscReliable.h
+    bool heartbeat = false;   // "/_rhb" announcement of the latest reliable sequence
+    uint32_t stream = 0;
+    uint32_t sequence = 0;
+
+    // Reads the header from the first decoded message of a packet
+    static oscSequenceInfo fromMessage(const ofxOscMessage &message);
+    const char *getAddress() const;
+};
+
+//-------------------------------------------------------------------------
+// oscSequenceTracker - Receiver side gap, duplicate and reorder detection
+//
+// Only touched by the receiving thread, counters are atomic so the panel can
+// read them from the main thread.
+//-------------------------------------------------------------------------
+class oscSequenceTracker {
+public:
+    enum class Verdict {
+        Accept,
+        Duplicate,
+        Late
+    };
+
+    // Called once per packet, every message of the packet shares the verdict
+    Verdict track(const oscSequenceInfo &info);
+    oscSequenceStats getStats() const;
+    void reset();
+
+private:
+    struct Stream {
+        uint32_t highest = 0;
+        uint64_t window = 0;   // Bit n set means (highest - n) has been seen
+    };
+
+    std::map<uint32_t, Stream> streams;
+
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> lost{0};
+    std::atomic<uint64_t> reordered{0};
+    std::atomic<uint64_t> duplicates{0};
+};
+
+#endif /* oscSequence_h */
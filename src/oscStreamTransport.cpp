@@ -0,0 +1,280 @@
+//
+//  oscStreamTransport.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscStreamTransport.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef MSG_NOSIGNAL
+#define OSC_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define OSC_SEND_FLAGS 0
+#endif
+
+static void configureStreamSocket(int fd){
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+#ifdef SO_NOSIGPIPE
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+}
+
+//-------------------------------------------------------------------------
+// oscSlip
+//-------------------------------------------------------------------------
+
+void oscSlip::encode(const char *data, size_t size, std::vector<char> &out){
+    const char END = (char)0xC0, ESC = (char)0xDB, ESC_END = (char)0xDC, ESC_ESC = (char)0xDD;
+    out.reserve(out.size() + size + 2);
+    out.push_back(END);
+    for(size_t i = 0; i < size; i++){
+        if(data[i] == END){
+            out.push_back(ESC);
+            out.push_back(ESC_END);
+        }else if(data[i] == ESC){
+            out.push_back(ESC);
+            out.push_back(ESC_ESC);
+        }else{
+            out.push_back(data[i]);
+        }
+    }
+    out.push_back(END);
+}
+
+//-------------------------------------------------------------------------
+// oscStreamConnection
+//-------------------------------------------------------------------------
+
+oscStreamConnection::oscStreamConnection(const oscEndpoint &_endpoint, const oscSocketAddress &_address)
+: endpoint(_endpoint)
+, address(_address)
+{
+    connect();
+}
+
+oscStreamConnection::~oscStreamConnection(){
+    if(fd >= 0) ::close(fd);
+}
+
+void oscStreamConnection::setSendBufferSize(int bytes){
+    sendBufferSize = bytes;
+    if(fd >= 0 && sendBufferSize > 0){
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+    }
+}
+
+void oscStreamConnection::connect(){
+    fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if(fd < 0){
+        disconnect(strerror(errno));
+        return;
+    }
+    configureStreamSocket(fd);
+    setSendBufferSize(sendBufferSize);
+    if(::connect(fd, reinterpret_cast<const sockaddr*>(&address.storage), address.length) == 0){
+        state = State::Connected;
+        connected = true;
+        backoffMs = OSC_STREAM_MIN_BACKOFF_MS;
+    }else if(errno == EINPROGRESS){
+        state = State::Connecting;
+    }else{
+        disconnect(strerror(errno));
+    }
+}
+
+void oscStreamConnection::disconnect(const std::string &reason){
+    if(fd >= 0){
+        ::close(fd);
+        fd = -1;
+    }
+    if(state == State::Connected){
+        ofLogNotice("oscStreamConnection") << "Lost connection to " << endpoint.toString() << ": " << reason;
+    }
+    state = State::Disconnected;
+    // Queued data is live state, it would be stale by the time we reconnect
+    pending.clear();
+    pendingOffset = 0;
+    nextAttempt = ofGetElapsedTimeMillis() + backoffMs;
+    backoffMs = std::min(backoffMs * 2, OSC_STREAM_MAX_BACKOFF_MS);
+}
+
+bool oscStreamConnection::takeConnected(){
+    bool wasConnected = connected;
+    connected = false;
+    return wasConnected;
+}
+
+bool oscStreamConnection::queue(const char *data, size_t size){
+    if(state != State::Connected) return false;
+    if(pending.size() - pendingOffset + size > OSC_STREAM_MAX_PENDING) return false;
+    oscSlip::encode(data, size, pending);
+    if(pending.size() - pendingOffset >= OSC_STREAM_FLUSH_THRESHOLD) flush();
+    return true;
+}
+
+void oscStreamConnection::update(){
+    switch(state){
+        case State::Disconnected:
+            if(ofGetElapsedTimeMillis() >= nextAttempt) connect();
+            break;
+        case State::Connecting:{
+            pollfd pfd = {fd, POLLOUT, 0};
+            if(poll(&pfd, 1, 0) <= 0) break;
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            if(error != 0){
+                disconnect(strerror(error));
+            }else{
+                state = State::Connected;
+                connected = true;
+                backoffMs = OSC_STREAM_MIN_BACKOFF_MS;
+                ofLogNotice("oscStreamConnection") << "Connected to " << endpoint.toString();
+            }
+            break;
+        }
+        case State::Connected:
+            flush();
+            break;
+    }
+}
+
+void oscStreamConnection::flush(){
+    while(pendingOffset < pending.size()){
+        ssize_t sent = ::send(fd, pending.data() + pendingOffset, pending.size() - pendingOffset, OSC_SEND_FLAGS);
+        if(sent > 0){
+            pendingOffset += sent;
+        }else if(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            // Kernel buffer full, the rest goes out next frame
+            break;
+        }else{
+            disconnect(sent == 0 ? "closed" : strerror(errno));
+            return;
+        }
+    }
+    if(pendingOffset == pending.size()){
+        pending.clear();
+        pendingOffset = 0;
+    }
+}
+
+//-------------------------------------------------------------------------
+// oscStreamServer
+//-------------------------------------------------------------------------
+
+oscStreamServer::~oscStreamServer(){
+    close();
+}
+
+bool oscStreamServer::bind(const oscEndpoint &local){
+    close();
+    listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    if(listener < 0){
+        ofLogError("oscStreamServer") << "Socket creation failed: " << strerror(errno);
+        return false;
+    }
+    int enable = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    fcntl(listener, F_SETFL, fcntl(listener, F_GETFL, 0) | O_NONBLOCK);
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(local.port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if(::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, 16) != 0){
+        ofLogError("oscStreamServer") << "Listen on " << local.toString() << " failed: " << strerror(errno);
+        close();
+        return false;
+    }
+    buffer.resize(64 * 1024);
+    return true;
+}
+
+void oscStreamServer::close(){
+    for(auto &client : clients){
+        ::close(client.fd);
+    }
+    clients.clear();
+    publishClients();
+    if(listener >= 0){
+        ::close(listener);
+        listener = -1;
+    }
+}
+
+void oscStreamServer::publishClients(){
+    numClients = clients.size();
+    int size = 0;
+    if(!clients.empty()){
+        socklen_t length = sizeof(size);
+        getsockopt(clients.front().fd, SOL_SOCKET, SO_RCVBUF, &size, &length);
+    }
+    clientBufferSize = size;
+}
+
+void oscStreamServer::receive(int timeoutMs, const std::function<void(const char*, size_t)> &onPacket){
+    if(listener < 0) return;
+    int requestedBufferSize = receiveBufferSize;
+    if(requestedBufferSize != appliedBufferSize){
+        appliedBufferSize = requestedBufferSize;
+        // 0 leaves connected clients alone, new ones get the system default
+        if(appliedBufferSize > 0){
+            for(auto &client : clients){
+                setsockopt(client.fd, SOL_SOCKET, SO_RCVBUF, &appliedBufferSize, sizeof(appliedBufferSize));
+            }
+            publishClients();
+        }
+    }
+    std::vector<pollfd> fds;
+    fds.push_back({listener, POLLIN, 0});
+    for(auto &client : clients){
+        fds.push_back({client.fd, POLLIN, 0});
+    }
+    if(poll(fds.data(), fds.size(), timeoutMs) <= 0) return;
+
+    // Read existing clients first, fds[i + 1] matches clients[i]
+    bool changed = false;
+    for(size_t i = clients.size(); i-- > 0;){
+        if(!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+        bool closed = false;
+        while(true){
+            ssize_t received = ::recv(clients[i].fd, buffer.data(), buffer.size(), 0);
+            if(received > 0){
+                clients[i].decoder.decode(buffer.data(), received, onPacket);
+            }else{
+                closed = (received == 0) || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+                break;
+            }
+        }
+        if(closed){
+            ::close(clients[i].fd);
+            clients.erase(clients.begin() + i);
+            changed = true;
+        }
+    }
+
+    if(fds[0].revents & POLLIN){
+        int fd;
+        while((fd = ::accept(listener, nullptr, nullptr)) >= 0){
+            configureStreamSocket(fd);
+            if(appliedBufferSize > 0){
+                setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &appliedBufferSize, sizeof(appliedBufferSize));
+            }
+            clients.push_back({fd, oscSlipDecoder()});
+            changed = true;
+        }
+    }
+    if(changed) publishClients();
+}
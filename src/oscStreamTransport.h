@@ -0,0 +1,158 @@
+//
+//  oscStreamTransport.h
+//  ofxOceanodeOsc
+//
+//  OSC 1.1 stream transport: packets SLIP framed (RFC 1055, double END) over
+//  TCP. Used by groups whose transport is set to TCP and by "tcp:host"
+//  destinations, for payloads that do not fit or must not be lost in UDP.
+//
+//  Nothing here ever blocks the caller: sockets are non-blocking, connects
+//  complete in update(), writes are coalesced per frame and failed links are
+//  retried with exponential backoff.
+//
+
+#ifndef oscStreamTransport_h
+#define oscStreamTransport_h
+
+#include "oscTransport.h"
+
+// Pending bytes that trigger an early flush, and the most we keep queued
+#define OSC_STREAM_FLUSH_THRESHOLD (64 * 1024)
+#define OSC_STREAM_MAX_PENDING (8 * 1024 * 1024)
+#define OSC_STREAM_MIN_BACKOFF_MS 100
+#define OSC_STREAM_MAX_BACKOFF_MS 5000
+
+//-------------------------------------------------------------------------
+// oscSlip - Framing helpers
+//-------------------------------------------------------------------------
+namespace oscSlip {
+    void encode(const char *data, size_t size, std::vector<char> &out);
+}
+
+class oscSlipDecoder {
+public:
+    // Calls onPacket for every complete frame found in data
+    template<typename Callback>
+    void decode(const char *data, size_t size, Callback &&onPacket);
+
+private:
+    std::vector<char> frame;
+    bool escaped = false;
+    bool overflow = false;
+};
+
+//-------------------------------------------------------------------------
+// oscStreamConnection - Outgoing TCP link to one destination
+//-------------------------------------------------------------------------
+class oscStreamConnection {
+public:
+    oscStreamConnection(const oscEndpoint &endpoint, const oscSocketAddress &address);
+    ~oscStreamConnection();
+
+    // Queues one packet, dropped while disconnected or when the queue is full
+    bool queue(const char *data, size_t size);
+    // Advances the connect / reconnect state machine and flushes queued bytes
+    void update();
+
+    bool isConnected() const {return state == State::Connected;};
+    // True once after every successful connect
+    bool takeConnected();
+    const oscEndpoint &getEndpoint() const {return endpoint;};
+    void setSendBufferSize(int bytes);
+
+private:
+    enum class State {
+        Disconnected,
+        Connecting,
+        Connected
+    };
+
+    void connect();
+    void disconnect(const std::string &reason);
+    void flush();
+
+    oscEndpoint endpoint;
+    oscSocketAddress address;
+    int fd = -1;
+    State state = State::Disconnected;
+    uint64_t nextAttempt = 0;
+    int backoffMs = OSC_STREAM_MIN_BACKOFF_MS;
+    int sendBufferSize = 0;
+    bool connected = false;
+
+    std::vector<char> pending;
+    size_t pendingOffset = 0;
+};
+
+//-------------------------------------------------------------------------
+// oscStreamServer - Listening TCP socket and its accepted clients
+//
+// Clients are only touched by the thread calling receive(). Other threads
+// read what it publishes and leave buffer size requests for it to apply.
+//-------------------------------------------------------------------------
+class oscStreamServer {
+public:
+    ~oscStreamServer();
+
+    bool bind(const oscEndpoint &local);
+    void close();
+    bool isOpen() const {return listener >= 0;};
+
+    // Waits up to timeoutMs for activity, onPacket(data, size) per received packet
+    void receive(int timeoutMs, const std::function<void(const char*, size_t)> &onPacket);
+
+    // Applied by the next receive() call, 0 keeps the system default
+    void setReceiveBufferSize(int bytes) {receiveBufferSize = bytes;};
+    // Effective buffer of the first client, 0 without clients
+    int getReceiveBufferSize() const {return clientBufferSize;};
+    size_t getNumClients() const {return numClients;};
+
+private:
+    struct Client {
+        int fd;
+        oscSlipDecoder decoder;
+    };
+
+    // Receive thread, after clients changed
+    void publishClients();
+
+    int listener = -1;
+    std::atomic<int> receiveBufferSize{0};
+    int appliedBufferSize = 0;
+    std::atomic<size_t> numClients{0};
+    std::atomic<int> clientBufferSize{0};
+    std::vector<Client> clients;
+    std::vector<char> buffer;
+};
+
+//-------------------------------------------------------------------------
+
+template<typename Callback>
+void oscSlipDecoder::decode(const char *data, size_t size, Callback &&onPacket){
+    const unsigned char END = 0xC0, ESC = 0xDB, ESC_END = 0xDC, ESC_ESC = 0xDD;
+    for(size_t i = 0; i < size; i++){
+        unsigned char byte = data[i];
+        if(byte == END){
+            if(!frame.empty() && !overflow) onPacket(frame.data(), frame.size());
+            frame.clear();
+            escaped = false;
+            overflow = false;
+            continue;
+        }
+        if(escaped){
+            byte = (byte == ESC_END) ? END : (byte == ESC_ESC) ? ESC : byte;
+            escaped = false;
+        }else if(byte == ESC){
+            escaped = true;
+            continue;
+        }
+        if(frame.size() >= OSC_STREAM_MAX_PACKET){
+            // Oversized frames are skipped up to the next END
+            overflow = true;
+            frame.clear();
+        }
+        if(!overflow) frame.push_back(byte);
+    }
+}
+
+#endif /* oscStreamTransport_h */
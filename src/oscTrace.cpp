@@ -0,0 +1,156 @@
+//
+//  oscTrace.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscTrace.h"
+
+#include <chrono>
+#include <fstream>
+
+namespace {
+    // Duration of marks, never the length of a real scope
+    const uint64_t markDuration = ~uint64_t(0);
+
+    struct Event {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> begin{0};
+        std::atomic<uint64_t> duration{0};
+    };
+
+    // Written only by its own thread, read by dump()
+    struct ThreadBuffer {
+        uint32_t id = 0;
+        std::string name;
+        std::unique_ptr<Event[]> events{new Event[OSC_TRACE_CAPACITY]};
+        std::atomic<uint64_t> head{0};
+        // Events before it were cleared, head itself only ever moves on its own thread
+        std::atomic<uint64_t> start{0};
+    };
+
+    std::mutex buffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t nextThreadId = 1;
+
+    thread_local const char *threadName = nullptr;
+    thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+
+    // Created the first time a thread traces, so threads that never do cost nothing
+    ThreadBuffer &getThreadBuffer(){
+        if(!threadBuffer){
+            auto buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            buffer->id = nextThreadId++;
+            buffer->name = threadName != nullptr ? threadName : "thread " + ofToString(buffer->id);
+            buffers.push_back(buffer);
+            threadBuffer = buffer;
+        }
+        return *threadBuffer;
+    }
+
+    void append(const char *name, uint64_t begin, uint64_t duration){
+        ThreadBuffer &buffer = getThreadBuffer();
+        uint64_t index = buffer.head.load(std::memory_order_relaxed);
+        Event &event = buffer.events[index & (OSC_TRACE_CAPACITY - 1)];
+        event.name.store(name, std::memory_order_relaxed);
+        event.begin.store(begin, std::memory_order_relaxed);
+        event.duration.store(duration, std::memory_order_relaxed);
+        buffer.head.store(index + 1, std::memory_order_release);
+    }
+}
+
+namespace oscTrace {
+    std::atomic<bool> enabledFlag{false};
+
+    void setEnabled(bool enabled){
+        enabledFlag.store(enabled, std::memory_order_relaxed);
+    }
+
+    uint64_t now(){
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void setThreadName(const char *name){
+        threadName = name;
+        if(threadBuffer){
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            threadBuffer->name = name;
+        }
+    }
+
+    void record(const char *name, uint64_t begin, uint64_t end){
+        append(name, begin, end - begin);
+    }
+
+    void mark(const char *name){
+        if(!isEnabled()) return;
+        append(name, now(), markDuration);
+    }
+
+    bool dump(const std::string &path){
+        std::vector<std::shared_ptr<ThreadBuffer>> threads;
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            threads = buffers;
+        }
+
+        std::ofstream file(path, std::ios::binary);
+        if(!file){
+            ofLogError("oscTrace") << "Could not open " << path;
+            return false;
+        }
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        for(auto &buffer : threads){
+            std::string name;
+            {
+                std::lock_guard<std::mutex> lock(buffersMutex);
+                name = buffer->name;
+            }
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+                 << ",\"args\":{\"name\":\"" << name << "\"}}";
+            first = false;
+
+            uint64_t end = buffer->head.load(std::memory_order_acquire);
+            uint64_t begin = std::max<uint64_t>(end > OSC_TRACE_CAPACITY ? end - OSC_TRACE_CAPACITY : 0, buffer->start.load(std::memory_order_relaxed));
+            std::vector<std::tuple<const char*, uint64_t, uint64_t>> events;
+            events.reserve(end - begin);
+            for(uint64_t index = begin; index < end; index++){
+                const Event &event = buffer->events[index & (OSC_TRACE_CAPACITY - 1)];
+                events.emplace_back(event.name.load(std::memory_order_relaxed),
+                                    event.begin.load(std::memory_order_relaxed),
+                                    event.duration.load(std::memory_order_relaxed));
+            }
+            // The thread kept writing while we copied, what it may have overwritten is dropped
+            uint64_t after = buffer->head.load(std::memory_order_acquire);
+            size_t skip = after + 1 > begin + OSC_TRACE_CAPACITY ? std::min<uint64_t>(after + 1 - begin - OSC_TRACE_CAPACITY, events.size()) : 0;
+            for(size_t i = skip; i < events.size(); i++){
+                const char *eventName = std::get<0>(events[i]);
+                uint64_t duration = std::get<2>(events[i]);
+                if(eventName == nullptr) continue;
+                file << ",\n{\"name\":\"" << eventName << "\",\"cat\":\"osc\",\"pid\":1,\"tid\":" << buffer->id
+                     << ",\"ts\":" << std::get<1>(events[i]);
+                if(duration == markDuration){
+                    file << ",\"ph\":\"i\",\"s\":\"p\"}";
+                }else{
+                    file << ",\"ph\":\"X\",\"dur\":" << duration << "}";
+                }
+            }
+        }
+        file << "\n]}\n";
+        if(!file){
+            ofLogError("oscTrace") << "Write to " << path << " failed";
+            return false;
+        }
+        ofLogNotice("oscTrace") << "Trace written to " << path;
+        return true;
+    }
+
+    void clear(){
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        // Threads keep their buffer, only the events go
+        for(auto &buffer : buffers){
+            buffer->start.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        }
+    }
+}
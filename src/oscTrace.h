@@ -0,0 +1,69 @@
+//
+//  oscTrace.h
+//  ofxOceanodeOsc
+//
+//  Timeline of where OSC time goes, exported as Chrome trace JSON that opens
+//  in chrome://tracing or ui.perfetto.dev next to the rest of the app.
+//
+//  OSC_TRACE_SCOPE("name") times the enclosing block. While tracing is off a
+//  scope is one relaxed load and a branch. While on, each thread appends to
+//  its own ring of events without locks, a dump copies every ring as it is.
+//  Names must be string literals, only the pointer is stored.
+//
+//  Define OSC_TRACE_DISABLED to compile the scopes out entirely.
+//
+
+#ifndef oscTrace_h
+#define oscTrace_h
+
+#include "ofMain.h"
+
+#include <atomic>
+
+// Events kept per thread, a power of two. Older ones are overwritten.
+#define OSC_TRACE_CAPACITY 65536
+
+namespace oscTrace {
+    extern std::atomic<bool> enabledFlag;
+
+    inline bool isEnabled() {return enabledFlag.load(std::memory_order_relaxed);}
+    void setEnabled(bool enabled);
+
+    // Microseconds on the steady clock the trace is written in
+    uint64_t now();
+
+    // Shown as the thread's name in the trace, call from the thread itself
+    void setThreadName(const char *name);
+
+    void record(const char *name, uint64_t begin, uint64_t end);
+    // Zero length event, used to show frame boundaries
+    void mark(const char *name);
+
+    // Writes the events of every thread that ever traced, false if the file could not be written
+    bool dump(const std::string &path);
+    void clear();
+}
+
+class oscTraceScope {
+public:
+    oscTraceScope(const char *_name) : name(oscTrace::isEnabled() ? _name : nullptr){
+        if(name != nullptr) begin = oscTrace::now();
+    }
+    ~oscTraceScope(){
+        if(name != nullptr) oscTrace::record(name, begin, oscTrace::now());
+    }
+
+private:
+    const char *name;
+    uint64_t begin = 0;
+};
+
+#ifdef OSC_TRACE_DISABLED
+#define OSC_TRACE_SCOPE(name)
+#else
+#define OSC_TRACE_CONCAT_INNER(a, b) a##b
+#define OSC_TRACE_CONCAT(a, b) OSC_TRACE_CONCAT_INNER(a, b)
+#define OSC_TRACE_SCOPE(name) oscTraceScope OSC_TRACE_CONCAT(oscTraceScope, __LINE__)(name)
+#endif
+
+#endif /* oscTrace_h */
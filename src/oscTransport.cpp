@@ -0,0 +1,1395 @@
+//
+//  oscTransport.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscTransport.h"
+#include "oscStreamTransport.h"
+#include "oscCapture.h"
+#include "oscTrace.h"
+#include "oscResolver.h"
+
+#include "OscOutboundPacketStream.h"
+#include "OscReceivedElements.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+//-------------------------------------------------------------------------
+// oscEndpoint
+//-------------------------------------------------------------------------
+
+static const std::string unixPrefix = "unix:";
+static const std::string tcpPrefix = "tcp:";
+
+bool oscEndpoint::isUnixAddress(const std::string &address){
+    return address.compare(0, unixPrefix.size(), unixPrefix) == 0;
+}
+
+bool oscEndpoint::isTcpAddress(const std::string &address){
+    return address.compare(0, tcpPrefix.size(), tcpPrefix) == 0;
+}
+
+oscEndpoint oscEndpoint::fromHostPort(const std::string &host, int port, bool stream){
+    oscEndpoint endpoint;
+    if(isUnixAddress(host)){
+        endpoint.type = Type::Unix;
+        endpoint.path = host.substr(unixPrefix.size());
+    }else if(isTcpAddress(host)){
+        endpoint.type = Type::Tcp;
+        endpoint.host = host.substr(tcpPrefix.size());
+        endpoint.port = port;
+    }else{
+        endpoint.type = stream ? Type::Tcp : Type::Udp;
+        endpoint.host = host;
+        endpoint.port = port;
+    }
+    return endpoint;
+}
+
+std::vector<oscEndpoint> oscEndpoint::fromHostList(const std::string &hosts, int defaultPort, bool stream){
+    std::vector<oscEndpoint> endpoints;
+    for(auto &entry : ofSplitString(hosts, ",", true, true)){
+        if(isUnixAddress(entry)){
+            endpoints.push_back(fromHostPort(entry, defaultPort));
+            continue;
+        }
+        // The port separator is searched after the "tcp:" scheme
+        size_t colon = entry.rfind(':');
+        if(colon != std::string::npos && colon >= (isTcpAddress(entry) ? tcpPrefix.size() : 0)){
+            endpoints.push_back(fromHostPort(entry.substr(0, colon), ofToInt(entry.substr(colon + 1)), stream));
+        }else{
+            endpoints.push_back(fromHostPort(entry, defaultPort, stream));
+        }
+    }
+    return endpoints;
+}
+
+size_t oscEndpoint::maxDatagramSize() const{
+    switch(type){
+        case Type::Unix: return OSC_UNIX_MAX_DATAGRAM;
+        case Type::Tcp: return OSC_STREAM_MAX_PACKET;
+        default: return OSC_UDP_MAX_DATAGRAM;
+    }
+}
+
+std::string oscEndpoint::toString() const{
+    if(isUnix()) return unixPrefix + path;
+    return (isTcp() ? tcpPrefix : "") + host + ":" + ofToString(port);
+}
+
+bool oscEndpoint::operator==(const oscEndpoint &other) const{
+    if(type != other.type) return false;
+    if(isUnix()) return path == other.path;
+    return host == other.host && port == other.port;
+}
+
+//-------------------------------------------------------------------------
+// oscPacketWriter
+//-------------------------------------------------------------------------
+
+static void appendMessage(osc::OutboundPacketStream &p, const ofxOscMessage &message){
+    p << osc::BeginMessage(message.getAddress().c_str());
+    for(size_t i = 0; i < message.getNumArgs(); i++){
+        switch(message.getArgType(i)){
+            case OFXOSC_TYPE_INT32:
+                p << message.getArgAsInt32(i);
+                break;
+            case OFXOSC_TYPE_INT64:
+                p << (osc::int64)message.getArgAsInt64(i);
+                break;
+            case OFXOSC_TYPE_FLOAT:
+                p << message.getArgAsFloat(i);
+                break;
+            case OFXOSC_TYPE_DOUBLE:
+                p << message.getArgAsDouble(i);
+                break;
+            case OFXOSC_TYPE_STRING:
+                p << message.getArgAsString(i).c_str();
+                break;
+            case OFXOSC_TYPE_SYMBOL:
+                p << osc::Symbol(message.getArgAsSymbol(i).c_str());
+                break;
+            case OFXOSC_TYPE_CHAR:
+                p << message.getArgAsChar(i);
+                break;
+            case OFXOSC_TYPE_MIDI_MESSAGE:
+                p << osc::MidiMessage(message.getArgAsMidiMessage(i));
+                break;
+            case OFXOSC_TYPE_TRUE:
+            case OFXOSC_TYPE_FALSE:
+                p << message.getArgAsBool(i);
+                break;
+            case OFXOSC_TYPE_TRIGGER:
+                p << osc::Infinitum;
+                break;
+            case OFXOSC_TYPE_NONE:
+                p << osc::OscNil;
+                break;
+            case OFXOSC_TYPE_TIMETAG:
+                p << osc::TimeTag(message.getArgAsTimetag(i));
+                break;
+            case OFXOSC_TYPE_RGBA_COLOR:
+                p << osc::RgbaColor(message.getArgAsRgbaColor(i));
+                break;
+            case OFXOSC_TYPE_BLOB:{
+                ofBuffer blob = message.getArgAsBlob(i);
+                p << osc::Blob(blob.getData(), (osc::osc_bundle_element_size_t)blob.size());
+                break;
+            }
+            default:
+                ofLogError("oscPacketWriter") << "Unsupported argument type " << message.getArgTypeName(i);
+                break;
+        }
+    }
+    p << osc::EndMessage;
+}
+
+static void appendSequence(osc::OutboundPacketStream &p, const oscSequenceInfo *sequence){
+    if(sequence == nullptr) return;
+    p << osc::BeginMessage(sequence->getAddress()) << (osc::int32)sequence->stream << (osc::int32)sequence->sequence << osc::EndMessage;
+}
+
+static void appendBundle(osc::OutboundPacketStream &p, const ofxOscBundle &bundle, const oscSequenceInfo *sequence = nullptr){
+    p << osc::BeginBundleImmediate;
+    appendSequence(p, sequence);
+    for(size_t i = 0; i < bundle.getBundleCount(); i++){
+        appendBundle(p, bundle.getBundleAt(i));
+    }
+    for(size_t i = 0; i < bundle.getMessageCount(); i++){
+        appendMessage(p, bundle.getMessageAt(i));
+    }
+    p << osc::EndBundle;
+}
+
+oscPacketWriter::oscPacketWriter(size_t maxSize) : maxPacketSize(maxSize){
+    buffer.resize(std::min<size_t>(maxSize, OSC_UDP_MAX_DATAGRAM));
+}
+
+void oscPacketWriter::setMaxSize(size_t maxSize){
+    maxPacketSize = maxSize;
+    if(buffer.size() > maxPacketSize) buffer.resize(maxPacketSize);
+}
+
+template<typename Writer>
+bool oscPacketWriter::write(Writer &&writer){
+    // Grow the buffer until the packet fits or we hit the transport limit
+    while(true){
+        try{
+            osc::OutboundPacketStream p(buffer.data(), buffer.size());
+            writer(p);
+            packetSize = p.Size();
+            return true;
+        }catch(const osc::OutOfBufferMemoryException &){
+            if(buffer.size() >= maxPacketSize){
+                packetSize = 0;
+                return false;
+            }
+            buffer.resize(std::min(buffer.size() * 2, maxPacketSize));
+        }
+    }
+}
+
+bool oscPacketWriter::writeMessage(const ofxOscMessage &message, bool wrapInBundle, const oscSequenceInfo *sequence){
+    wrapInBundle |= (sequence != nullptr);
+    return write([&message, wrapInBundle, sequence](osc::OutboundPacketStream &p){
+        if(wrapInBundle) p << osc::BeginBundleImmediate;
+        appendSequence(p, sequence);
+        appendMessage(p, message);
+        if(wrapInBundle) p << osc::EndBundle;
+    });
+}
+
+bool oscPacketWriter::writeBundle(const ofxOscBundle &bundle, const oscSequenceInfo *sequence){
+    return write([&bundle, sequence](osc::OutboundPacketStream &p){
+        appendBundle(p, bundle, sequence);
+    });
+}
+
+//-------------------------------------------------------------------------
+// oscPacketReader
+//-------------------------------------------------------------------------
+
+static void readMessage(const osc::ReceivedMessage &m, ofxOscMessage &message){
+    message.setAddress(m.AddressPattern());
+    for(osc::ReceivedMessage::const_iterator arg = m.ArgumentsBegin(); arg != m.ArgumentsEnd(); ++arg){
+        switch(arg->TypeTag()){
+            case osc::INT32_TYPE_TAG:
+                message.addIntArg(arg->AsInt32Unchecked());
+                break;
+            case osc::INT64_TYPE_TAG:
+                message.addInt64Arg(arg->AsInt64Unchecked());
+                break;
+            case osc::FLOAT_TYPE_TAG:
+                message.addFloatArg(arg->AsFloatUnchecked());
+                break;
+            case osc::DOUBLE_TYPE_TAG:
+                message.addDoubleArg(arg->AsDoubleUnchecked());
+                break;
+            case osc::STRING_TYPE_TAG:
+                message.addStringArg(arg->AsStringUnchecked());
+                break;
+            case osc::SYMBOL_TYPE_TAG:
+                message.addSymbolArg(arg->AsSymbolUnchecked());
+                break;
+            case osc::CHAR_TYPE_TAG:
+                message.addCharArg(arg->AsCharUnchecked());
+                break;
+            case osc::MIDI_MESSAGE_TYPE_TAG:
+                message.addMidiMessageArg(arg->AsMidiMessageUnchecked());
+                break;
+            case osc::TRUE_TYPE_TAG:
+            case osc::FALSE_TYPE_TAG:
+                message.addBoolArg(arg->AsBoolUnchecked());
+                break;
+            case osc::INFINITUM_TYPE_TAG:
+                message.addTriggerArg();
+                break;
+            case osc::NIL_TYPE_TAG:
+                message.addNoneArg();
+                break;
+            case osc::TIME_TAG_TYPE_TAG:
+                message.addTimetagArg(arg->AsTimeTagUnchecked());
+                break;
+            case osc::RGBA_COLOR_TYPE_TAG:
+                message.addRgbaColorArg(arg->AsRgbaColorUnchecked());
+                break;
+            case osc::BLOB_TYPE_TAG:{
+                const void *blobData;
+                osc::osc_bundle_element_size_t blobSize;
+                arg->AsBlobUnchecked(blobData, blobSize);
+                ofBuffer blob((const char*)blobData, blobSize);
+                message.addBlobArg(blob);
+                break;
+            }
+            default:
+                ofLogError("oscPacketReader") << "Unsupported argument type " << arg->TypeTag();
+                break;
+        }
+    }
+}
+
+static void readBundle(const osc::ReceivedBundle &b, std::vector<ofxOscMessage> &messages){
+    for(osc::ReceivedBundle::const_iterator element = b.ElementsBegin(); element != b.ElementsEnd(); ++element){
+        if(element->IsBundle()){
+            readBundle(osc::ReceivedBundle(*element), messages);
+        }else{
+            messages.emplace_back();
+            readMessage(osc::ReceivedMessage(*element), messages.back());
+        }
+    }
+}
+
+bool oscPacketReader::read(const char *data, size_t size, std::vector<ofxOscMessage> &messages){
+    try{
+        osc::ReceivedPacket p(data, (osc::osc_bundle_element_size_t)size);
+        if(p.IsBundle()){
+            readBundle(osc::ReceivedBundle(p), messages);
+        }else{
+            messages.emplace_back();
+            readMessage(osc::ReceivedMessage(p), messages.back());
+        }
+        return true;
+    }catch(const osc::Exception &e){
+        ofLogError("oscPacketReader") << "Malformed packet: " << e.what();
+        return false;
+    }
+}
+
+//-------------------------------------------------------------------------
+// oscSocketAddress
+//-------------------------------------------------------------------------
+
+static bool fillUnixAddress(const std::string &path, sockaddr_storage &storage, socklen_t &length){
+    sockaddr_un *address = reinterpret_cast<sockaddr_un*>(&storage);
+    if(path.empty() || path.size() >= sizeof(address->sun_path)){
+        ofLogError("oscDatagramSocket") << "Invalid unix socket path: " << path;
+        return false;
+    }
+    memset(&storage, 0, sizeof(storage));
+    address->sun_family = AF_UNIX;
+    strncpy(address->sun_path, path.c_str(), sizeof(address->sun_path) - 1);
+    length = sizeof(sockaddr_un);
+    return true;
+}
+
+static bool fillUdpAddress(const std::string &host, int port, sockaddr_storage &storage, socklen_t &length, bool *retry = nullptr){
+    memset(&storage, 0, sizeof(storage));
+    sockaddr_in *address = reinterpret_cast<sockaddr_in*>(&storage);
+    address->sin_family = AF_INET;
+    address->sin_port = htons(port);
+    length = sizeof(sockaddr_in);
+    if(host.empty()){
+        address->sin_addr.s_addr = htonl(INADDR_ANY);
+        return true;
+    }
+    // Names not in the resolver cache yet are looked up in the background
+    auto status = oscResolver::shared().lookup(host, address->sin_addr);
+    if(retry != nullptr) *retry = (status != oscResolver::Status::Resolved);
+    return status == oscResolver::Status::Resolved;
+}
+
+bool oscSocketAddress::resolve(const oscEndpoint &endpoint, oscSocketAddress &address, bool *retry){
+    if(retry != nullptr) *retry = false;
+    if(endpoint.isUnix()){
+        return fillUnixAddress(endpoint.path, address.storage, address.length);
+    }
+    return fillUdpAddress(endpoint.host, endpoint.port, address.storage, address.length, retry);
+}
+
+bool oscSocketAddress::operator==(const oscSocketAddress &other) const{
+    return length == other.length && memcmp(&storage, &other.storage, length) == 0;
+}
+
+bool oscSocketAddress::isMulticast() const{
+    if(storage.ss_family != AF_INET) return false;
+    const sockaddr_in *address = reinterpret_cast<const sockaddr_in*>(&storage);
+    return IN_MULTICAST(ntohl(address->sin_addr.s_addr));
+}
+
+//-------------------------------------------------------------------------
+// oscDatagramSocket
+//-------------------------------------------------------------------------
+
+oscDatagramSocket::~oscDatagramSocket(){
+    close();
+}
+
+bool oscDatagramSocket::open(oscEndpoint::Type type){
+    close();
+    bool isUnix = (type == oscEndpoint::Type::Unix);
+    fd = ::socket(isUnix ? AF_UNIX : AF_INET, SOCK_DGRAM, 0);
+    if(fd < 0){
+        ofLogError("oscDatagramSocket") << "Socket creation failed: " << strerror(errno);
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    if(isUnix){
+        int bufferSize = OSC_UNIX_SOCKET_BUFFER;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    }else{
+        // Same behaviour as ofxOscSender, broadcast addresses are allowed
+        int enable = 1;
+        setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable));
+    }
+    return true;
+}
+
+bool oscDatagramSocket::bind(const oscEndpoint &endpoint){
+    sockaddr_storage address;
+    socklen_t length;
+    bool resolved = endpoint.isUnix() ?
+        fillUnixAddress(endpoint.path, address, length) :
+        fillUdpAddress("", endpoint.port, address, length);
+    if(!resolved || !open(endpoint.type)) return false;
+
+    if(endpoint.isUnix()){
+        // Remove a stale socket file left by a previous run, never a regular file
+        struct stat info;
+        if(lstat(endpoint.path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)){
+            unlink(endpoint.path.c_str());
+        }
+    }else{
+        int enable = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    }
+
+    if(::bind(fd, reinterpret_cast<sockaddr*>(&address), length) != 0){
+        ofLogError("oscDatagramSocket") << "Bind to " << endpoint.toString() << " failed: " << strerror(errno);
+        close();
+        return false;
+    }
+    if(endpoint.isUnix()) boundPath = endpoint.path;
+#ifdef SO_RXQ_OVFL
+    int enable = 1;
+    if(setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) == 0){
+        kernelDrops = 0;
+    }
+#endif
+    return true;
+}
+
+void oscDatagramSocket::close(){
+    if(fd >= 0){
+        ::close(fd);
+        fd = -1;
+    }
+    kernelDrops = -1;
+    if(!boundPath.empty()){
+        unlink(boundPath.c_str());
+        boundPath.clear();
+    }
+}
+
+bool oscDatagramSocket::setBufferSizes(int receiveBytes, int sendBytes){
+    if(fd < 0) return false;
+    bool success = true;
+    if(receiveBytes > 0){
+        success &= setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBytes, sizeof(receiveBytes)) == 0;
+    }
+    if(sendBytes > 0){
+        success &= setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBytes, sizeof(sendBytes)) == 0;
+    }
+    if(!success){
+        ofLogError("oscDatagramSocket") << "Could not set socket buffer sizes: " << strerror(errno);
+    }
+    return success;
+}
+
+int oscDatagramSocket::getBufferSize(int option) const{
+    if(fd < 0) return 0;
+    int size = 0;
+    socklen_t length = sizeof(size);
+    if(getsockopt(fd, SOL_SOCKET, option, &size, &length) != 0) return 0;
+    return size;
+}
+
+int oscDatagramSocket::getReceiveBufferSize() const{
+    return getBufferSize(SO_RCVBUF);
+}
+
+int oscDatagramSocket::getSendBufferSize() const{
+    return getBufferSize(SO_SNDBUF);
+}
+
+bool oscDatagramSocket::setMulticast(int ttl, const std::string &interfaceAddress){
+    if(fd < 0) return false;
+    unsigned char multicastTtl = ofClamp(ttl, 0, 255);
+    bool success = setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &multicastTtl, sizeof(multicastTtl)) == 0;
+    in_addr interface;
+    interface.s_addr = htonl(INADDR_ANY);
+    if(!interfaceAddress.empty() && inet_pton(AF_INET, interfaceAddress.c_str(), &interface) != 1){
+        ofLogError("oscDatagramSocket") << "Invalid multicast interface " << interfaceAddress;
+        return false;
+    }
+    success &= setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &interface, sizeof(interface)) == 0;
+    if(!success){
+        ofLogError("oscDatagramSocket") << "Could not set multicast options: " << strerror(errno);
+    }
+    return success;
+}
+
+static bool changeMembership(int fd, int option, const std::string &groupAddress, const std::string &interfaceAddress){
+    ip_mreq request;
+    request.imr_interface.s_addr = htonl(INADDR_ANY);
+    if(inet_pton(AF_INET, groupAddress.c_str(), &request.imr_multiaddr) != 1 ||
+       (!interfaceAddress.empty() && inet_pton(AF_INET, interfaceAddress.c_str(), &request.imr_interface) != 1)){
+        ofLogError("oscDatagramSocket") << "Invalid multicast group " << groupAddress << " / interface " << interfaceAddress;
+        return false;
+    }
+    if(setsockopt(fd, IPPROTO_IP, option, &request, sizeof(request)) != 0){
+        ofLogError("oscDatagramSocket") << "Multicast membership change for " << groupAddress << " failed: " << strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool oscDatagramSocket::joinMulticast(const std::string &groupAddress, const std::string &interfaceAddress){
+    if(fd < 0) return false;
+    return changeMembership(fd, IP_ADD_MEMBERSHIP, groupAddress, interfaceAddress);
+}
+
+bool oscDatagramSocket::leaveMulticast(const std::string &groupAddress, const std::string &interfaceAddress){
+    if(fd < 0) return false;
+    return changeMembership(fd, IP_DROP_MEMBERSHIP, groupAddress, interfaceAddress);
+}
+
+bool oscDatagramSocket::countDrop(){
+    // Unix sockets push back when the reader is behind
+    if(errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS) return false;
+    sendDrops++;
+    return true;
+}
+
+bool oscDatagramSocket::sendTo(const char *data, size_t size, const oscSocketAddress &address){
+    if(fd < 0) return false;
+    ssize_t sent = ::sendto(fd, data, size, 0, reinterpret_cast<const sockaddr*>(&address.storage), address.length);
+    if(sent == (ssize_t)size) return true;
+    if(sent < 0 && !countDrop()){
+        ofLogVerbose("oscDatagramSocket") << "Send failed: " << strerror(errno);
+    }
+    return false;
+}
+
+size_t oscDatagramSocket::sendToAll(const char *data, size_t size, const std::vector<oscSocketAddress> &addresses){
+    if(fd < 0 || addresses.empty()) return 0;
+    if(addresses.size() == 1) return sendTo(data, size, addresses[0]) ? 1 : 0;
+#ifdef __linux__
+    // One iovec shared by every header, the payload is never copied
+    iovec payload = {const_cast<char*>(data), size};
+    std::vector<mmsghdr> headers(addresses.size());
+    for(size_t i = 0; i < addresses.size(); i++){
+        msghdr &header = headers[i].msg_hdr;
+        memset(&header, 0, sizeof(header));
+        header.msg_name = const_cast<sockaddr_storage*>(&addresses[i].storage);
+        header.msg_namelen = addresses[i].length;
+        header.msg_iov = &payload;
+        header.msg_iovlen = 1;
+    }
+    size_t delivered = 0;
+    size_t next = 0;
+    while(next < headers.size()){
+        int sent = sendmmsg(fd, headers.data() + next, headers.size() - next, 0);
+        if(sent > 0){
+            delivered += sent;
+            next += sent;
+        }else{
+            // Skip the destination that failed and carry on with the rest
+            if(!countDrop()) ofLogVerbose("oscDatagramSocket") << "Send failed: " << strerror(errno);
+            next++;
+        }
+    }
+    return delivered;
+#else
+    size_t delivered = 0;
+    for(auto &address : addresses){
+        if(sendTo(data, size, address)) delivered++;
+    }
+    return delivered;
+#endif
+}
+
+ssize_t oscDatagramSocket::receive(char *data, size_t size, int timeoutMs, oscSocketAddress *source){
+    if(fd < 0) return -1;
+    pollfd pfd = {fd, POLLIN, 0};
+    int ready = poll(&pfd, 1, timeoutMs);
+    if(ready <= 0) return ready;
+
+    iovec payload = {data, size};
+    // Control messages are read through cmsghdr pointers, the buffer must be aligned for them
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint32_t))];
+    msghdr header;
+    memset(&header, 0, sizeof(header));
+    header.msg_iov = &payload;
+    header.msg_iovlen = 1;
+    header.msg_control = control;
+    header.msg_controllen = sizeof(control);
+    if(source != nullptr){
+        header.msg_name = &source->storage;
+        header.msg_namelen = sizeof(source->storage);
+    }
+
+    ssize_t received = ::recvmsg(fd, &header, 0);
+    if(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+    if(source != nullptr) source->length = (received >= 0) ? header.msg_namelen : 0;
+#ifdef SO_RXQ_OVFL
+    // The kernel attaches its running drop count once the first drop happened
+    for(cmsghdr *message = CMSG_FIRSTHDR(&header); received >= 0 && message != nullptr; message = CMSG_NXTHDR(&header, message)){
+        if(message->cmsg_level == SOL_SOCKET && message->cmsg_type == SO_RXQ_OVFL){
+            uint32_t drops;
+            memcpy(&drops, CMSG_DATA(message), sizeof(drops));
+            kernelDrops = drops;
+        }
+    }
+#endif
+    return received;
+}
+
+//-------------------------------------------------------------------------
+// oscTransportSender
+//-------------------------------------------------------------------------
+
+oscTransportSender::oscTransportSender(){
+}
+
+oscTransportSender::~oscTransportSender(){
+}
+
+bool oscTransportSender::setup(const std::string &hosts, int port, bool stream){
+    clear();
+    endpoints = oscEndpoint::fromHostList(hosts, port, stream);
+
+    // Fresh stream id so receivers do not mistake us for the previous setup
+    static std::mt19937 generator(std::random_device{}());
+    sequenceInfo.sequenced = true;
+    sequenceInfo.stream = generator();
+    sequenceInfo.sequence = 0;
+    frameInfo.framed = true;
+    frameInfo.stream = sequenceInfo.stream;
+    frameInfo.frame = 0;
+    reliableInfo.sequenced = true;
+    reliableInfo.reliable = true;
+    reliableInfo.stream = generator();
+    reliableInfo.sequence = 0;
+
+    size_t maxSize = OSC_STREAM_MAX_PACKET;
+    for(auto &endpoint : endpoints){
+        maxSize = std::min(maxSize, endpoint.maxDatagramSize());
+        oscSocketAddress address;
+        bool retry;
+        if(oscSocketAddress::resolve(endpoint, address, &retry)){
+            addDestination(endpoint, address);
+        }else if(retry){
+            // Added by update() once the resolver has an answer
+            unresolved.push_back(endpoint);
+        }else{
+            ofLogError("oscTransportSender") << "Skipping destination " << endpoint.toString();
+        }
+    }
+    writer.setMaxSize(maxSize);
+
+    if(!isReady() && unresolved.empty()){
+        ofLogError("oscTransportSender") << "Could not set up sender to " << hosts;
+        return false;
+    }
+    return true;
+}
+
+void oscTransportSender::addDestination(const oscEndpoint &endpoint, const oscSocketAddress &address){
+    // Literals and localhost never change, names are looked up again by recheckNames()
+    in_addr numeric;
+    if(!endpoint.isUnix() && endpoint.host != "localhost" && inet_pton(AF_INET, endpoint.host.c_str(), &numeric) != 1){
+        namedDestinations.push_back({endpoint, address, endpoint.isTcp() ? streams.size() : udpDestinations.size()});
+    }
+    if(endpoint.isTcp()){
+        // Connects in the background, packets are dropped until it is up
+        streams.push_back(std::make_unique<oscStreamConnection>(endpoint, address));
+        streams.back()->setSendBufferSize(sendBufferSize);
+    }else if(endpoint.isUnix()){
+        unixDestinations.push_back(address);
+        if(!unixSocket.isOpen() && unixSocket.open(oscEndpoint::Type::Unix)){
+            unixSocket.setBufferSizes(0, sendBufferSize);
+        }
+    }else{
+        udpDestinations.push_back(address);
+        if(!udpSocket.isOpen() && udpSocket.open(oscEndpoint::Type::Udp)){
+            udpSocket.setBufferSizes(0, sendBufferSize);
+        }
+        if(udpSocket.isOpen() && address.isMulticast()) udpSocket.setMulticast(multicastTtl, multicastInterface);
+    }
+}
+
+void oscTransportSender::clear(){
+    udpSocket.close();
+    unixSocket.close();
+    streams.clear();
+    snapshotStreams.clear();
+    snapshotAddresses.clear();
+    endpoints.clear();
+    unresolved.clear();
+    namedDestinations.clear();
+    udpDestinations.clear();
+    unixDestinations.clear();
+}
+
+void oscTransportSender::setMulticastOptions(int ttl, const std::string &interfaceAddress){
+    multicastTtl = ttl;
+    multicastInterface = interfaceAddress;
+    if(udpSocket.isOpen() && hasMulticastDestinations()){
+        udpSocket.setMulticast(multicastTtl, multicastInterface);
+    }
+}
+
+void oscTransportSender::setSendBufferSize(int bytes){
+    sendBufferSize = bytes;
+    udpSocket.setBufferSizes(0, sendBufferSize);
+    unixSocket.setBufferSizes(0, sendBufferSize);
+    for(auto &stream : streams){
+        stream->setSendBufferSize(sendBufferSize);
+    }
+}
+
+size_t oscTransportSender::getNumConnectedStreams() const{
+    return std::count_if(streams.begin(), streams.end(), [](const std::unique_ptr<oscStreamConnection> &stream){
+        return stream->isConnected();
+    });
+}
+
+oscSocketStats oscTransportSender::getStats() const{
+    oscSocketStats stats;
+    stats.packets = packetsSent;
+    stats.errors = sendErrors;
+    stats.sendDrops = udpSocket.getSendDrops() + unixSocket.getSendDrops();
+    stats.bufferSize = udpSocket.isOpen() ? udpSocket.getSendBufferSize() : unixSocket.getSendBufferSize();
+    return stats;
+}
+
+bool oscTransportSender::hasMulticastDestinations() const{
+    return std::any_of(udpDestinations.begin(), udpDestinations.end(), [](const oscSocketAddress &address){
+        return address.isMulticast();
+    });
+}
+
+bool oscTransportSender::sendWritten(){
+    OSC_TRACE_SCOPE("osc.sendto");
+    size_t delivered = udpSocket.sendToAll(writer.data(), writer.size(), udpDestinations);
+    delivered += unixSocket.sendToAll(writer.data(), writer.size(), unixDestinations);
+    for(auto &stream : streams){
+        if(stream->queue(writer.data(), writer.size())) delivered++;
+    }
+    packetsSent += delivered;
+    sendErrors += udpDestinations.size() + unixDestinations.size() + streams.size() - delivered;
+    return delivered > 0;
+}
+
+const oscSequenceInfo *oscTransportSender::nextSequence(){
+    if(!sequencing) return nullptr;
+    sequenceInfo.sequence++;
+    return &sequenceInfo;
+}
+
+bool oscTransportSender::sendMessage(const ofxOscMessage &message, bool wrapInBundle){
+    if(!isReady()) return false;
+    {
+        OSC_TRACE_SCOPE("osc.serialize");
+        if(!writer.writeMessage(message, wrapInBundle, nextSequence())){
+            ofLogError("oscTransportSender") << "Message " << message.getAddress() << " too big for destination";
+            return false;
+        }
+    }
+    return sendWritten();
+}
+
+bool oscTransportSender::sendReliableMessage(const ofxOscMessage &message){
+    if(!isReady()) return false;
+    reliableInfo.sequence++;
+    {
+        OSC_TRACE_SCOPE("osc.serialize");
+        if(!writer.writeMessage(message, true, &reliableInfo)){
+            ofLogError("oscTransportSender") << "Message " << message.getAddress() << " too big for destination";
+            return false;
+        }
+    }
+    if(!retransmitBuffer.store(reliableInfo.sequence, writer.data(), writer.size())){
+        ofLogWarning("oscTransportSender") << "Reliable message " << message.getAddress() << " too big to be retransmitted";
+    }
+    return sendWritten();
+}
+
+void oscTransportSender::update(){
+    // Host names that were still resolving, a cache read each until they are
+    for(size_t i = unresolved.size(); i-- > 0;){
+        oscSocketAddress address;
+        if(oscSocketAddress::resolve(unresolved[i], address)){
+            addDestination(unresolved[i], address);
+            unresolved.erase(unresolved.begin() + i);
+        }
+    }
+    recheckNames();
+
+    // One write per stream and frame, whatever was queued since the last one
+    for(auto &stream : streams){
+        stream->update();
+        if(stream->takeConnected() && snapshots) snapshotStreams.push_back(stream.get());
+    }
+    if(!udpSocket.isOpen() || !(retransmitBuffer.isAllocated() || snapshots)) return;
+
+    // NACKs come back to our ephemeral port from every receiver that missed something
+    char reply[OSC_UDP_MAX_DATAGRAM];
+    oscSocketAddress source;
+    std::vector<ofxOscMessage> messages;
+    ssize_t size;
+    while((size = udpSocket.receive(reply, sizeof(reply), 0, &source)) > 0){
+        messages.clear();
+        if(!oscPacketReader::read(reply, size, messages)) continue;
+        for(auto &nack : messages){
+            if(nack.getAddress() == OSC_SNAPSHOT_ADDRESS && snapshots){
+                // Several queries from one receiver in a frame get one answer
+                bool known = std::any_of(snapshotAddresses.begin(), snapshotAddresses.end(), [&source](const oscSocketAddress &address){
+                    return address.length == source.length && memcmp(&address.storage, &source.storage, source.length) == 0;
+                });
+                if(!known) snapshotAddresses.push_back(source);
+                continue;
+            }
+            if(nack.getAddress() != OSC_NACK_ADDRESS || nack.getNumArgs() < 2) continue;
+            if((uint32_t)nack.getArgAsInt32(0) != reliableInfo.stream) continue;
+            for(size_t i = 1; i < nack.getNumArgs(); i++){
+                const char *data;
+                size_t dataSize;
+                if(retransmitBuffer.find((uint32_t)nack.getArgAsInt32(i), data, dataSize)){
+                    udpSocket.sendTo(data, dataSize, source);
+                    retransmitted++;
+                }
+            }
+        }
+    }
+
+    // Lets receivers notice a lost packet even when nothing else follows it
+    if(!retransmitBuffer.isAllocated()) return;
+    uint64_t now = ofGetElapsedTimeMillis();
+    if(now - lastHeartbeat >= OSC_RELIABLE_HEARTBEAT_MS){
+        lastHeartbeat = now;
+        oscSequenceInfo heartbeat = reliableInfo;
+        heartbeat.heartbeat = true;
+        if(writer.writeBundle(ofxOscBundle(), &heartbeat)){
+            udpSocket.sendToAll(writer.data(), writer.size(), udpDestinations);
+        }
+    }
+}
+
+void oscTransportSender::recheckNames(){
+    // A cache read per name, often enough to follow a refresh soon after it lands
+    uint64_t now = ofGetElapsedTimeMillis();
+    if(namedDestinations.empty() || now - lastNameCheck < OSC_RESOLVER_RETRY_MS) return;
+    lastNameCheck = now;
+    for(auto &named : namedDestinations){
+        oscSocketAddress address;
+        if(!oscSocketAddress::resolve(named.endpoint, address) || address == named.address) continue;
+        ofLogNotice("oscTransportSender") << named.endpoint.toString() << " has a new address, switching to it";
+        // Only the slot of this name, literals or other names with the same address keep theirs
+        if(named.endpoint.isTcp()){
+            auto &stream = streams[named.index];
+            snapshotStreams.erase(std::remove(snapshotStreams.begin(), snapshotStreams.end(), stream.get()), snapshotStreams.end());
+            stream = std::make_unique<oscStreamConnection>(named.endpoint, address);
+            stream->setSendBufferSize(sendBufferSize);
+        }else{
+            udpDestinations[named.index] = address;
+            if(udpSocket.isOpen() && address.isMulticast()) udpSocket.setMulticast(multicastTtl, multicastInterface);
+        }
+        named.address = address;
+    }
+}
+
+bool oscTransportSender::sendBundle(const ofxOscBundle &bundle){
+    if(!isReady()) return false;
+    if(!writer.writeBundle(bundle, nextSequence())){
+        ofLogError("oscTransportSender") << "Bundle too big for destination";
+        return false;
+    }
+    return sendWritten();
+}
+
+template<typename Send>
+void oscTransportSender::sendPacked(const std::vector<ofxOscMessage> &messages, bool sequenced, oscFrameInfo *frame, Send &&send){
+    // Serializing, with the sends of every full bundle nested in it
+    OSC_TRACE_SCOPE("osc.serialize");
+    // Messages too big are left out before the frame header announces its size,
+    // so receivers never wait for them
+    packedSizes.resize(messages.size());
+    uint32_t fitting = 0;
+    for(size_t i = 0; i < messages.size(); i++){
+        packedSizes[i] = 0;
+        if(!writer.writeMessage(messages[i], false)){
+            ofLogError("oscTransportSender") << "Message " << messages[i].getAddress() << " too big for destination";
+            continue;
+        }
+        packedSizes[i] = writer.size() + 4;
+        fitting++;
+    }
+    if(frame) frame->messages = fitting;
+
+    // Bundle header, sequence and frame elements, then 4 size bytes per element
+    const size_t headerSize = 16 + (sequenced ? 24 : 0) + (frame ? 32 : 0);
+    ofxOscBundle bundle;
+    size_t bundleSize = headerSize;
+    auto start = [&](){
+        bundle.clear();
+        bundleSize = headerSize;
+        if(frame) bundle.addMessage(frame->toMessage());
+    };
+    auto flush = [&](){
+        if(bundle.getMessageCount() <= (frame ? 1 : 0)) return;
+        if(writer.writeBundle(bundle, sequenced ? nextSequence() : nullptr)) send();
+        start();
+    };
+    start();
+    for(size_t i = 0; i < messages.size(); i++){
+        size_t messageSize = packedSizes[i];
+        if(messageSize == 0) continue;
+        if(bundleSize + messageSize > OSC_SNAPSHOT_BUNDLE_SIZE) flush();
+        bundle.addMessage(messages[i]);
+        bundleSize += messageSize;
+    }
+    flush();
+}
+
+bool oscTransportSender::sendMessages(const std::vector<ofxOscMessage> &messages){
+    if(!isReady()) return false;
+    bool success = true;
+    sendPacked(messages, sequencing, nullptr, [this, &success](){
+        success &= sendWritten();
+    });
+    return success;
+}
+
+bool oscTransportSender::sendFrame(const std::vector<ofxOscMessage> &messages){
+    if(!isReady() || messages.empty()) return false;
+    frameInfo.frame++;
+    bool success = true;
+    sendPacked(messages, sequencing, &frameInfo, [this, &success](){
+        success &= sendWritten();
+    });
+    return success;
+}
+
+void oscTransportSender::sendSnapshot(const std::vector<ofxOscMessage> &messages){
+    if(!hasSnapshotRequests()) return;
+    sendPacked(messages, false, nullptr, [this](){
+        for(auto &address : snapshotAddresses){
+            udpSocket.sendTo(writer.data(), writer.size(), address);
+        }
+        for(auto *stream : snapshotStreams){
+            stream->queue(writer.data(), writer.size());
+        }
+    });
+    snapshotsSent += snapshotAddresses.size() + snapshotStreams.size();
+    snapshotAddresses.clear();
+    snapshotStreams.clear();
+}
+
+//-------------------------------------------------------------------------
+// oscReceivePort
+//-------------------------------------------------------------------------
+
+static std::mutex portsMutex;
+static std::map<std::string, std::weak_ptr<oscReceivePort>> ports;
+
+std::shared_ptr<oscReceivePort> oscReceivePort::acquire(const oscEndpoint &local){
+    std::lock_guard<std::mutex> lock(portsMutex);
+    auto &existing = ports[local.toString()];
+    if(auto port = existing.lock()){
+        return port;
+    }
+    auto port = std::make_shared<oscReceivePort>(local);
+    if(!port->isOpen()){
+        return nullptr;
+    }
+    existing = port;
+    return port;
+}
+
+oscReceivePort::oscReceivePort(const oscEndpoint &local) : endpoint(local){
+    bool bound;
+    if(endpoint.isTcp()){
+        streamServer = std::make_unique<oscStreamServer>();
+        bound = streamServer->bind(endpoint);
+    }else{
+        bound = socket.bind(endpoint);
+    }
+    if(bound){
+        defaultBufferSize = streamServer ? 0 : socket.getReceiveBufferSize();
+#ifdef __linux__
+        // Linux reports twice what was set, to account for its bookkeeping
+        defaultBufferSize /= 2;
+#endif
+        running = true;
+        thread = std::thread(&oscReceivePort::threadedFunction, this);
+    }
+}
+
+oscReceivePort::~oscReceivePort(){
+    running = false;
+    if(thread.joinable()){
+        thread.join();
+    }
+    for(auto &membership : memberships){
+        auto groupAndInterface = ofSplitString(membership.first, "@");
+        socket.leaveMulticast(groupAndInterface[0], groupAndInterface.size() > 1 ? groupAndInterface[1] : "");
+    }
+    socket.close();
+    if(streamServer) streamServer->close();
+}
+
+bool oscReceivePort::isOpen() const{
+    return streamServer ? streamServer->isOpen() : socket.isOpen();
+}
+
+size_t oscReceivePort::getNumClients() const{
+    return streamServer ? streamServer->getNumClients() : 0;
+}
+
+void oscReceivePort::subscribe(const std::string &prefix, oscTransportReceiver *receiver){
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    subscribers.push_back(receiver);
+    if(!prefix.empty()){
+        if(prefixedSubscribers.count(prefix) != 0){
+            ofLogWarning("oscReceivePort") << "Prefix /" << prefix << " already in use on " << endpoint.toString();
+        }
+        prefixedSubscribers[prefix] = receiver;
+    }
+}
+
+void oscReceivePort::unsubscribe(oscTransportReceiver *receiver){
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), receiver), subscribers.end());
+    for(auto it = prefixedSubscribers.begin(); it != prefixedSubscribers.end();){
+        if(it->second == receiver){
+            it = prefixedSubscribers.erase(it);
+        }else{
+            ++it;
+        }
+    }
+    if(requestedBufferSizes.erase(receiver) != 0) applyReceiveBufferSize();
+    snapshotRequesters.erase(receiver);
+    snapshotRequests = !snapshotRequesters.empty();
+}
+
+void oscReceivePort::addRecorder(oscCaptureRecorder *recorder){
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    if(std::find(recorders.begin(), recorders.end(), recorder) == recorders.end()){
+        recorders.push_back(recorder);
+    }
+}
+
+void oscReceivePort::removeRecorder(oscCaptureRecorder *recorder){
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    recorders.erase(std::remove(recorders.begin(), recorders.end(), recorder), recorders.end());
+}
+
+bool oscReceivePort::joinMulticast(const std::string &groupAddress, const std::string &interfaceAddress){
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    int &count = memberships[groupAddress + "@" + interfaceAddress];
+    if(count == 0 && !socket.joinMulticast(groupAddress, interfaceAddress)){
+        memberships.erase(groupAddress + "@" + interfaceAddress);
+        return false;
+    }
+    count++;
+    return true;
+}
+
+void oscReceivePort::leaveMulticast(const std::string &groupAddress, const std::string &interfaceAddress){
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    auto membership = memberships.find(groupAddress + "@" + interfaceAddress);
+    if(membership == memberships.end()) return;
+    if(--membership->second == 0){
+        socket.leaveMulticast(groupAddress, interfaceAddress);
+        memberships.erase(membership);
+    }
+}
+
+void oscReceivePort::requestReceiveBufferSize(oscTransportReceiver *receiver, int bytes){
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    if(bytes > 0){
+        requestedBufferSizes[receiver] = bytes;
+    }else{
+        requestedBufferSizes.erase(receiver);
+    }
+    applyReceiveBufferSize();
+}
+
+void oscReceivePort::requestSnapshots(oscTransportReceiver *receiver, bool enabled){
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    if(enabled){
+        snapshotRequesters.insert(receiver);
+    }else{
+        snapshotRequesters.erase(receiver);
+    }
+    snapshotRequests = !snapshotRequesters.empty();
+}
+
+void oscReceivePort::applyReceiveBufferSize(){
+    int bytes = 0;
+    for(auto &requested : requestedBufferSizes){
+        bytes = std::max(bytes, requested.second);
+    }
+    if(bytes == receiveBufferSize) return;
+    if(streamServer){
+        streamServer->setReceiveBufferSize(bytes);
+        receiveBufferSize = bytes;
+    }else if(socket.setBufferSizes(bytes > 0 ? bytes : defaultBufferSize, 0)){
+        receiveBufferSize = bytes;
+    }
+}
+
+oscSocketStats oscReceivePort::getStats() const{
+    oscSocketStats stats;
+    stats.packets = packetsReceived;
+    stats.errors = malformedPackets;
+    stats.kernelDrops = socket.getKernelDrops();
+    stats.bufferSize = streamServer ? streamServer->getReceiveBufferSize() : socket.getReceiveBufferSize();
+    return stats;
+}
+
+void oscReceivePort::threadedFunction(){
+    if(streamServer){
+        oscTrace::setThreadName("osc stream receive");
+        auto onPacket = [this](const char *data, size_t size){
+            handlePacket(data, size, nullptr);
+        };
+        while(running){
+            streamServer->receive(20, onPacket);
+        }
+        return;
+    }
+    oscTrace::setThreadName("osc receive");
+    std::vector<char> buffer(endpoint.maxDatagramSize());
+    oscSocketAddress source;
+    while(running){
+        ssize_t size = socket.receive(buffer.data(), buffer.size(), 20, &source);
+        if(size > 0){
+            handlePacket(buffer.data(), size, &source);
+            if(snapshotRequests) requestSnapshot(source);
+        }
+        if(!reliableSources.empty()) sendNacks();
+    }
+}
+
+void oscReceivePort::handlePacket(const char *data, size_t size, const oscSocketAddress *source){
+    OSC_TRACE_SCOPE("osc.receive");
+    packetsReceived++;
+    {
+        std::lock_guard<std::mutex> lock(subscribersMutex);
+        for(auto *recorder : recorders){
+            recorder->record(data, size);
+        }
+    }
+    received.clear();
+    if(!oscPacketReader::read(data, size, received) || received.empty()){
+        malformedPackets++;
+        return;
+    }
+    // A sequence header is always the first element of the packet
+    oscSequenceInfo sequence = oscSequenceInfo::fromMessage(received.front());
+    bool accepted = true;
+    if(sequence.reliable){
+        if(source != nullptr){
+            // Capped like the tracker's streams, which forget them at the same point
+            if(reliableSources.size() >= OSC_SEQUENCE_MAX_STREAMS && reliableSources.count(sequence.stream) == 0){
+                reliableSources.clear();
+            }
+            reliableSources[sequence.stream] = *source;
+        }
+        accepted = reliableTracker.track(sequence);
+    }
+    // A frame header follows the sequence header, if any
+    size_t first = sequence.sequenced ? 1 : 0;
+    oscFrameInfo frame;
+    if(first < received.size()){
+        frame = oscFrameInfo::fromMessage(received[first]);
+        if(frame.framed) first++;
+    }
+    std::lock_guard<std::mutex> lock(subscribersMutex);
+    packetVerdicts.clear();
+    for(size_t i = first; accepted && i < received.size(); i++){
+        if(sequence.reliable && !reliableTracker.shouldApply(received[i].getAddress(), sequence)) continue;
+        dispatch(received[i], sequence, frame);
+    }
+}
+
+void oscReceivePort::sendNacks(){
+    std::map<uint32_t, std::vector<uint32_t>> nacks;
+    reliableTracker.collectNacks(ofGetElapsedTimeMillis(), nacks);
+    for(auto &nack : nacks){
+        auto source = reliableSources.find(nack.first);
+        // Unnamed sockets (unix senders) cannot be answered
+        if(source == reliableSources.end() || source->second.length <= sizeof(sa_family_t)) continue;
+        ofxOscMessage message;
+        message.setAddress(OSC_NACK_ADDRESS);
+        message.addIntArg((int32_t)nack.first);
+        for(auto sequence : nack.second){
+            message.addIntArg((int32_t)sequence);
+        }
+        if(nackWriter.writeMessage(message, false)){
+            socket.sendTo(nackWriter.data(), nackWriter.size(), source->second);
+        }
+    }
+}
+
+void oscReceivePort::requestSnapshot(const oscSocketAddress &source){
+    // Unnamed sockets (unix senders) cannot be answered
+    if(source.length <= sizeof(sa_family_t)) return;
+    uint64_t now = ofGetElapsedTimeMillis();
+    std::string key(reinterpret_cast<const char*>(&source.storage), source.length);
+    auto heard = lastHeard.find(key);
+    bool silent = (heard == lastHeard.end()) || (now - heard->second > OSC_SNAPSHOT_SILENCE_MS);
+    if(heard == lastHeard.end() && lastHeard.size() >= 256) lastHeard.clear();
+    lastHeard[key] = now;
+    if(!silent) return;
+
+    ofxOscMessage query;
+    query.setAddress(OSC_SNAPSHOT_ADDRESS);
+    if(nackWriter.writeMessage(query, false) && socket.sendTo(nackWriter.data(), nackWriter.size(), source)){
+        snapshotsRequested++;
+    }
+}
+
+void oscReceivePort::dispatch(ofxOscMessage &message, const oscSequenceInfo &sequence, const oscFrameInfo &frame){
+    const std::string &address = message.getAddress();
+    // First path segment selects the receiver: "/prefix/rest" -> "/rest"
+    size_t separator = address.find('/', 1);
+    if(separator != std::string::npos && !prefixedSubscribers.empty()){
+        auto subscriber = prefixedSubscribers.find(address.substr(1, separator - 1));
+        if(subscriber != prefixedSubscribers.end()){
+            if(!accepts(subscriber->second, sequence)) return;
+            message.setAddress(address.substr(separator));
+            subscriber->second->pushMessage(std::move(message), frame);
+            return;
+        }
+    }
+    // The last receiver that accepts the packet gets the message itself, the others a copy
+    size_t last = subscribers.size();
+    for(size_t i = 0; i < subscribers.size(); i++){
+        if(accepts(subscribers[i], sequence)) last = i;
+    }
+    for(size_t i = 0; i < last; i++){
+        if(accepts(subscribers[i], sequence)) subscribers[i]->pushMessage(ofxOscMessage(message), frame);
+    }
+    if(last < subscribers.size()){
+        subscribers[last]->pushMessage(std::move(message), frame);
+    }
+}
+
+bool oscReceivePort::accepts(oscTransportReceiver *receiver, const oscSequenceInfo &sequence){
+    // Reliable packets were already filtered by the port
+    if(!sequence.sequenced || sequence.reliable) return true;
+    for(auto &verdict : packetVerdicts){
+        if(verdict.first == receiver) return verdict.second;
+    }
+    // Duplicates and packets older than data the receiver already applied are discarded
+    bool accepted = receiver->sequenceTracker.track(sequence) == oscSequenceTracker::Verdict::Accept;
+    packetVerdicts.emplace_back(receiver, accepted);
+    return accepted;
+}
+
+//-------------------------------------------------------------------------
+// oscTransportReceiver
+//-------------------------------------------------------------------------
+
+oscTransportReceiver::~oscTransportReceiver(){
+    stop();
+}
+
+bool oscTransportReceiver::setup(int port){
+    return setup(oscEndpoint::fromHostPort("", port));
+}
+
+bool oscTransportReceiver::setup(const oscEndpoint &local, const std::string &_prefix){
+    stop();
+    endpoint = local;
+    prefix = _prefix;
+    port = oscReceivePort::acquire(endpoint);
+    if(port == nullptr){
+        return false;
+    }
+    resetTracking();
+    port->subscribe(prefix, this);
+    if(recorder != nullptr) port->addRecorder(recorder);
+    port->requestSnapshots(this, snapshotRequests);
+    port->requestReceiveBufferSize(this, receiveBufferSize);
+    return true;
+}
+
+void oscTransportReceiver::setSnapshotRequests(bool enabled){
+    snapshotRequests = enabled;
+    if(port != nullptr) port->requestSnapshots(this, snapshotRequests);
+}
+
+void oscTransportReceiver::setReceiveBufferSize(int bytes){
+    receiveBufferSize = bytes;
+    if(port != nullptr) port->requestReceiveBufferSize(this, receiveBufferSize);
+}
+
+oscSocketStats oscTransportReceiver::getStats() const{
+    if(port == nullptr) return oscSocketStats();
+    return port->getStats();
+}
+
+void oscTransportReceiver::stop(){
+    if(port != nullptr){
+        for(auto &joined : joinedGroups){
+            port->leaveMulticast(joined.first, joined.second);
+        }
+        port->unsubscribe(this);
+        if(recorder != nullptr) port->removeRecorder(recorder);
+        port.reset();
+    }
+    joinedGroups.clear();
+    {
+        std::lock_guard<std::mutex> lock(messagesMutex);
+        messages.clear();
+    }
+    resetTracking();
+}
+
+void oscTransportReceiver::resetTracking(){
+    sequenceTracker.reset();
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    frameAssembler.reset();
+}
+
+bool oscTransportReceiver::joinMulticast(const std::string &groupAddresses, const std::string &interfaceAddress){
+    if(port == nullptr || endpoint.type != oscEndpoint::Type::Udp) return false;
+    bool success = true;
+    for(auto &groupAddress : ofSplitString(groupAddresses, ",", true, true)){
+        if(port->joinMulticast(groupAddress, interfaceAddress)){
+            joinedGroups.emplace_back(groupAddress, interfaceAddress);
+        }else{
+            success = false;
+        }
+    }
+    return success;
+}
+
+void oscTransportReceiver::pushMessage(ofxOscMessage &&message, const oscFrameInfo &frame){
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    if(observer) observer(message);
+    if(frame.framed){
+        // Held back until the whole frame is here, then queued in one go
+        frameAssembler.add(std::move(message), frame, messages);
+    }else{
+        messages.push_back(std::move(message));
+    }
+}
+
+void oscTransportReceiver::setObserver(std::function<void(const ofxOscMessage&)> _observer){
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    observer = std::move(_observer);
+}
+
+void oscTransportReceiver::setRecorder(oscCaptureRecorder *_recorder){
+    if(port != nullptr){
+        if(recorder != nullptr) port->removeRecorder(recorder);
+        if(_recorder != nullptr) port->addRecorder(_recorder);
+    }
+    recorder = _recorder;
+}
+
+bool oscTransportReceiver::injectPacket(const char *data, size_t size){
+    std::vector<ofxOscMessage> received;
+    if(!oscPacketReader::read(data, size, received) || received.empty()) return false;
+    oscSequenceInfo sequence = oscSequenceInfo::fromMessage(received.front());
+    size_t first = sequence.sequenced ? 1 : 0;
+    oscFrameInfo frame;
+    if(first < received.size()){
+        frame = oscFrameInfo::fromMessage(received[first]);
+        if(frame.framed) first++;
+    }
+    if(!sequence.reliable && sequenceTracker.track(sequence) != oscSequenceTracker::Verdict::Accept) return true;
+    // Same routing as the port, except that messages for other prefixes cannot be told apart
+    const std::string ownPrefix = "/" + prefix + "/";
+    for(size_t i = first; i < received.size(); i++){
+        const std::string &address = received[i].getAddress();
+        if(!prefix.empty() && address.compare(0, ownPrefix.size(), ownPrefix) == 0){
+            received[i].setAddress(address.substr(ownPrefix.size() - 1));
+        }
+        pushMessage(std::move(received[i]), frame);
+    }
+    return true;
+}
+
+size_t oscTransportReceiver::getNumWaitingMessages(){
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    return messages.size();
+}
+
+bool oscTransportReceiver::hasWaitingMessages(){
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    return !messages.empty();
+}
+
+bool oscTransportReceiver::takeMessages(std::deque<ofxOscMessage> &taken){
+    taken.clear();
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    frameAssembler.expire(ofGetElapsedTimeMillis(), messages);
+    std::swap(taken, messages);
+    return !taken.empty();
+}
+
+bool oscTransportReceiver::getNextMessage(ofxOscMessage &message){
+    std::lock_guard<std::mutex> lock(messagesMutex);
+    if(messages.empty()) return false;
+    message = std::move(messages.front());
+    messages.pop_front();
+    return true;
+}
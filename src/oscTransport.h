@@ -0,0 +1,454 @@
+//
+//  oscTransport.h
+//  ofxOceanodeOsc
+//
+//  Socket level transport used by the OSC variable groups and the oscSender
+//  node. Mirrors the ofxOscSender / ofxOscReceiver interface so it can be used
+//  as a drop-in replacement, but also accepts "unix:/path/to/socket" endpoints
+//  that travel over AF_UNIX datagram sockets instead of the UDP loopback, and
+//  "tcp:host" endpoints that use the SLIP framed stream of oscStreamTransport.h.
+//
+
+#ifndef oscTransport_h
+#define oscTransport_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+#include "oscSequence.h"
+#include "oscReliable.h"
+#include "oscFrame.h"
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+
+// Largest payload a single UDP datagram can carry
+#define OSC_UDP_MAX_DATAGRAM 65507
+// Unix datagrams are not fragmented, we allow them to be much bigger
+#define OSC_UNIX_MAX_DATAGRAM (1024 * 1024)
+// Kernel buffer requested for unix sockets so big datagrams fit
+#define OSC_UNIX_SOCKET_BUFFER (4 * 1024 * 1024)
+// Largest packet accepted on a TCP stream
+#define OSC_STREAM_MAX_PACKET (16 * 1024 * 1024)
+
+// Late joiner sync: receivers send "/_snapshot" to a sender they hear from for
+// the first time (or again after a silence) and the sender answers with the
+// current value of every variable, packed in bundles that fit one frame
+#define OSC_SNAPSHOT_ADDRESS "/_snapshot"
+#define OSC_SNAPSHOT_BUNDLE_SIZE 1400
+#define OSC_SNAPSHOT_SILENCE_MS 2000
+
+//-------------------------------------------------------------------------
+// oscEndpoint
+//-------------------------------------------------------------------------
+struct oscEndpoint {
+    enum class Type {
+        Udp,
+        Unix,
+        Tcp
+    };
+
+    Type type = Type::Udp;
+    std::string host;
+    int port = 0;
+    std::string path;
+
+    // host can be a regular hostname / ip, "unix:/path/to/socket" or "tcp:host".
+    // stream turns plain hosts into TCP endpoints.
+    static oscEndpoint fromHostPort(const std::string &host, int port, bool stream = false);
+    static bool isUnixAddress(const std::string &address);
+    static bool isTcpAddress(const std::string &address);
+    // Comma separated destination list, entries can be "host", "host:port", "tcp:host:port" or "unix:/path"
+    static std::vector<oscEndpoint> fromHostList(const std::string &hosts, int defaultPort, bool stream = false);
+
+    bool isUnix() const {return type == Type::Unix;};
+    bool isTcp() const {return type == Type::Tcp;};
+    size_t maxDatagramSize() const;
+    std::string toString() const;
+
+    bool operator==(const oscEndpoint &other) const;
+    bool operator!=(const oscEndpoint &other) const {return !(*this == other);};
+};
+
+//-------------------------------------------------------------------------
+// oscPacketWriter - Serializes ofxOsc messages into a reusable buffer
+//-------------------------------------------------------------------------
+class oscPacketWriter {
+public:
+    oscPacketWriter(size_t maxSize = OSC_UDP_MAX_DATAGRAM);
+
+    void setMaxSize(size_t maxSize);
+
+    // Returns false if the packet does not fit in maxSize. A sequence header
+    // forces a bundle and is written as its first element.
+    bool writeMessage(const ofxOscMessage &message, bool wrapInBundle, const oscSequenceInfo *sequence = nullptr);
+    bool writeBundle(const ofxOscBundle &bundle, const oscSequenceInfo *sequence = nullptr);
+
+    const char* data() const {return buffer.data();};
+    size_t size() const {return packetSize;};
+
+private:
+    template<typename Writer>
+    bool write(Writer &&writer);
+
+    std::vector<char> buffer;
+    size_t maxPacketSize;
+    size_t packetSize = 0;
+};
+
+//-------------------------------------------------------------------------
+// oscPacketReader - Parses a raw datagram into ofxOscMessages
+//-------------------------------------------------------------------------
+namespace oscPacketReader {
+    // Appends every message found in the packet (bundles are flattened)
+    bool read(const char *data, size_t size, std::vector<ofxOscMessage> &messages);
+}
+
+//-------------------------------------------------------------------------
+// oscSocketStats - Counters shown in the controller panel
+//-------------------------------------------------------------------------
+struct oscSocketStats {
+    uint64_t packets = 0;       // Datagrams read or written
+    uint64_t errors = 0;        // Malformed packets on receive, failed writes on send
+    int64_t kernelDrops = -1;   // Receive side overflow drops, -1 when the platform cannot report it
+    uint64_t sendDrops = 0;     // Send side datagrams dropped because the socket was full
+    int bufferSize = 0;         // Effective kernel buffer in bytes
+};
+
+//-------------------------------------------------------------------------
+// oscSocketAddress - Resolved destination of a datagram
+//-------------------------------------------------------------------------
+struct oscSocketAddress {
+    sockaddr_storage storage;
+    socklen_t length = 0;
+
+    // Host names go through oscResolver and never block. retry is set when the
+    // name is still being looked up or will be looked up again.
+    static bool resolve(const oscEndpoint &endpoint, oscSocketAddress &address, bool *retry = nullptr);
+    bool isMulticast() const;
+    bool operator==(const oscSocketAddress &other) const;
+};
+
+//-------------------------------------------------------------------------
+// oscDatagramSocket - Thin wrapper over an AF_INET / AF_UNIX datagram socket
+//-------------------------------------------------------------------------
+class oscDatagramSocket {
+public:
+    oscDatagramSocket() = default;
+    ~oscDatagramSocket();
+
+    oscDatagramSocket(const oscDatagramSocket&) = delete;
+    oscDatagramSocket& operator=(const oscDatagramSocket&) = delete;
+
+    bool open(oscEndpoint::Type type);
+    bool bind(const oscEndpoint &local);
+    void close();
+
+    // Requested SO_RCVBUF / SO_SNDBUF in bytes, 0 keeps the system default
+    bool setBufferSizes(int receiveBytes, int sendBytes);
+    int getReceiveBufferSize() const;
+    int getSendBufferSize() const;
+    // Datagrams the kernel dropped because the receive buffer was full (SO_RXQ_OVFL)
+    int64_t getKernelDrops() const {return kernelDrops;};
+    // Datagrams not sent because the socket had no room, see sendTo
+    uint64_t getSendDrops() const {return sendDrops;};
+
+    bool setMulticast(int ttl, const std::string &interfaceAddress);
+    bool joinMulticast(const std::string &groupAddress, const std::string &interfaceAddress);
+    bool leaveMulticast(const std::string &groupAddress, const std::string &interfaceAddress);
+
+    // Never waits: when the socket is full (a unix reader that fell behind) the
+    // datagram is dropped and counted, so a slow reader cannot stall the frame
+    bool sendTo(const char *data, size_t size, const oscSocketAddress &address);
+    // Same payload to every address, batched in a single syscall where available
+    size_t sendToAll(const char *data, size_t size, const std::vector<oscSocketAddress> &addresses);
+    // Waits up to timeoutMs, returns bytes read, 0 on timeout and -1 on error
+    ssize_t receive(char *data, size_t size, int timeoutMs, oscSocketAddress *source = nullptr);
+
+    bool isOpen() const {return fd >= 0;};
+    int getFileDescriptor() const {return fd;};
+
+private:
+    // Counts the drop if the last send failed for lack of room
+    bool countDrop();
+    int getBufferSize(int option) const;
+
+    int fd = -1;
+    std::string boundPath;
+    std::atomic<int64_t> kernelDrops{-1};
+    std::atomic<uint64_t> sendDrops{0};
+};
+
+//-------------------------------------------------------------------------
+// oscTransportSender - ofxOscSender replacement
+//
+// Every packet is serialized once and written to all destinations, which
+// can be any mix of unicast, subnet broadcast, multicast and unix sockets.
+//-------------------------------------------------------------------------
+class oscStreamConnection;
+class oscStreamServer;
+class oscCaptureRecorder;
+
+class oscTransportSender {
+public:
+    oscTransportSender();
+    ~oscTransportSender();
+
+    // hosts is a single host or a comma separated destination list, stream
+    // sends to plain hosts over TCP instead of UDP
+    bool setup(const std::string &hosts, int port, bool stream = false);
+    void clear();
+    bool isReady() const {return udpSocket.isOpen() || unixSocket.isOpen() || !streams.empty();};
+
+    // Multicast TTL and outgoing interface (empty for the default route)
+    void setMulticastOptions(int ttl, const std::string &interfaceAddress);
+    bool hasMulticastDestinations() const;
+
+    bool sendMessage(const ofxOscMessage &message, bool wrapInBundle = true);
+    bool sendBundle(const ofxOscBundle &bundle);
+    // Many messages at once, packed in as few frame sized bundles as possible
+    bool sendMessages(const std::vector<ofxOscMessage> &messages);
+    // Like sendMessages, receivers apply all of them together, see oscFrame.h
+    bool sendFrame(const std::vector<ofxOscMessage> &messages);
+    // Sent on the reliable stream and kept for retransmission, see oscReliable.h
+    bool sendReliableMessage(const ofxOscMessage &message);
+
+    // Answers NACKs, sends reliable heartbeats and flushes TCP streams, call once per frame.
+    // Destinations whose host name was still resolving are added here once it is.
+    void update();
+    // Some destinations are waiting for their host name, packets do not reach them yet
+    bool isResolving() const {return !unresolved.empty();};
+
+    const std::vector<oscEndpoint> &getEndpoints() const {return endpoints;};
+    size_t getNumStreams() const {return streams.size();};
+    size_t getNumConnectedStreams() const;
+
+    void setSendBufferSize(int bytes);
+    oscSocketStats getStats() const;
+
+    // Opt-in "/_seq" header on every packet, see oscSequence.h
+    void setSequencing(bool enabled) {sequencing = enabled;};
+    bool isSequencing() const {return sequencing;};
+
+    // Answer "/_snapshot" queries, and treat every new TCP connection as a query
+    void setSnapshots(bool enabled) {snapshots = enabled;};
+    bool hasSnapshotRequests() const {return !snapshotAddresses.empty() || !snapshotStreams.empty();};
+    // Sends the messages to everyone that asked since the last call
+    void sendSnapshot(const std::vector<ofxOscMessage> &messages);
+    uint64_t getSnapshotsSent() const {return snapshotsSent;};
+
+private:
+    // Sets frame->messages to the number of messages that fit the destination
+    template<typename Send>
+    void sendPacked(const std::vector<ofxOscMessage> &messages, bool sequenced, oscFrameInfo *frame, Send &&send);
+    bool sendWritten();
+    const oscSequenceInfo *nextSequence();
+    // Opens the socket the destination needs if it is not open yet
+    void addDestination(const oscEndpoint &endpoint, const oscSocketAddress &address);
+    // Points destinations given by name at their current address
+    void recheckNames();
+
+    std::vector<oscEndpoint> endpoints;
+    std::vector<oscEndpoint> unresolved;
+    // Resolved names and the address in use, the resolver refreshes them every OSC_RESOLVER_TTL_MS
+    struct NamedDestination {
+        oscEndpoint endpoint;
+        oscSocketAddress address;
+        size_t index;   // Slot in udpDestinations, or in streams for TCP
+    };
+    std::vector<NamedDestination> namedDestinations;
+    uint64_t lastNameCheck = 0;
+    std::vector<oscSocketAddress> udpDestinations;
+    std::vector<oscSocketAddress> unixDestinations;
+    oscDatagramSocket udpSocket;
+    oscDatagramSocket unixSocket;
+    std::vector<std::unique_ptr<oscStreamConnection>> streams;
+    oscPacketWriter writer;
+    std::vector<size_t> packedSizes;    // Serialized size per message, 0 if too big
+
+    int multicastTtl = 1;
+    std::string multicastInterface;
+
+    int sendBufferSize = 0;
+    uint64_t packetsSent = 0;
+    uint64_t sendErrors = 0;
+
+    bool sequencing = false;
+    oscSequenceInfo sequenceInfo;
+    oscFrameInfo frameInfo;
+
+    oscSequenceInfo reliableInfo;
+    oscRetransmitBuffer retransmitBuffer;
+    uint64_t lastHeartbeat = 0;
+    uint64_t retransmitted = 0;
+
+    bool snapshots = false;
+    std::vector<oscSocketAddress> snapshotAddresses;
+    std::vector<oscStreamConnection*> snapshotStreams;
+    uint64_t snapshotsSent = 0;
+};
+
+class oscTransportReceiver;
+
+//-------------------------------------------------------------------------
+// oscReceivePort - One bound socket and one thread shared by every receiver
+// listening on the same endpoint.
+//
+// Messages addressed "/prefix/..." go only to the receiver subscribed with
+// that prefix, with the prefix stripped. Anything else is delivered to every
+// receiver on the port, so a port used by a single group behaves as before.
+//-------------------------------------------------------------------------
+class oscReceivePort {
+public:
+    oscReceivePort(const oscEndpoint &local);
+    ~oscReceivePort();
+
+    // Returns the live port for this endpoint, binding it if needed
+    static std::shared_ptr<oscReceivePort> acquire(const oscEndpoint &local);
+
+    bool isOpen() const;
+    const oscEndpoint &getEndpoint() const {return endpoint;};
+    // Connected TCP senders, 0 for datagram ports
+    size_t getNumClients() const;
+
+    void subscribe(const std::string &prefix, oscTransportReceiver *receiver);
+    void unsubscribe(oscTransportReceiver *receiver);
+
+    // Reference counted IGMP membership, shared by all receivers of the port
+    bool joinMulticast(const std::string &groupAddress, const std::string &interfaceAddress);
+    void leaveMulticast(const std::string &groupAddress, const std::string &interfaceAddress);
+
+    // The port uses the largest buffer its current receivers ask for, 0 for
+    // the system default. Recomputed when a request changes or a receiver leaves.
+    void requestReceiveBufferSize(oscTransportReceiver *receiver, int bytes);
+    oscSocketStats getStats() const;
+    oscReliableStats getReliableStats() const {return reliableTracker.getStats();};
+
+    // Every packet the port reads is also handed to the recorders
+    void addRecorder(oscCaptureRecorder *recorder);
+    void removeRecorder(oscCaptureRecorder *recorder);
+
+    // Senders are asked for snapshots while any current receiver of the port wants them
+    void requestSnapshots(oscTransportReceiver *receiver, bool enabled);
+    uint64_t getSnapshotsRequested() const {return snapshotsRequested;};
+
+private:
+    void threadedFunction();
+    // source is null for stream packets, which are never NACKed
+    void handlePacket(const char *data, size_t size, const oscSocketAddress *source);
+    void dispatch(ofxOscMessage &message, const oscSequenceInfo &sequence, const oscFrameInfo &frame);
+    // Sequence verdict of the current packet for receiver, tracked on first use
+    bool accepts(oscTransportReceiver *receiver, const oscSequenceInfo &sequence);
+    void sendNacks();
+    void requestSnapshot(const oscSocketAddress &source);
+    // Called with subscribersMutex held
+    void applyReceiveBufferSize();
+
+    oscEndpoint endpoint;
+    oscDatagramSocket socket;
+    std::unique_ptr<oscStreamServer> streamServer;
+    std::thread thread;
+    std::atomic<bool> running{false};
+
+    std::mutex subscribersMutex;
+    std::vector<oscTransportReceiver*> subscribers;
+    std::map<std::string, oscTransportReceiver*> prefixedSubscribers;
+    std::map<std::string, int> memberships;
+    std::vector<oscCaptureRecorder*> recorders;
+
+    std::map<oscTransportReceiver*, int> requestedBufferSizes;
+    int receiveBufferSize = 0;
+    int defaultBufferSize = 0;  // As set by the system when the socket was bound
+    std::atomic<uint64_t> packetsReceived{0};
+    std::vector<ofxOscMessage> received;
+    std::vector<std::pair<oscTransportReceiver*, bool>> packetVerdicts;
+
+    oscReliableTracker reliableTracker;
+    std::map<uint32_t, oscSocketAddress> reliableSources;
+    oscPacketWriter nackWriter;
+    std::atomic<uint64_t> malformedPackets{0};
+
+    std::set<oscTransportReceiver*> snapshotRequesters;
+    std::atomic<bool> snapshotRequests{false};
+    std::map<std::string, uint64_t> lastHeard;
+    std::atomic<uint64_t> snapshotsRequested{0};
+};
+
+//-------------------------------------------------------------------------
+// oscTransportReceiver - ofxOscReceiver replacement
+//-------------------------------------------------------------------------
+class oscTransportReceiver {
+public:
+    ~oscTransportReceiver();
+
+    bool setup(int port);
+    // prefix lets several receivers share one port, see oscReceivePort
+    bool setup(const oscEndpoint &local, const std::string &prefix = "");
+    void stop();
+    bool isListening() const {return port != nullptr;};
+
+    // groupAddresses is a single multicast group or a comma separated list
+    bool joinMulticast(const std::string &groupAddresses, const std::string &interfaceAddress);
+
+    void setReceiveBufferSize(int bytes);
+    // Stats of the shared port this receiver listens on
+    oscSocketStats getStats() const;
+    // Loss and reorder stats of sequenced streams received by this receiver
+    oscSequenceStats getSequenceStats() const {return sequenceTracker.getStats();};
+    oscReliableStats getReliableStats() const {return port ? port->getReliableStats() : oscReliableStats();};
+    // Connected TCP senders when listening on a stream endpoint
+    size_t getNumClients() const {return port ? port->getNumClients() : 0;};
+
+    // Ask every sender we start hearing from for its full state, see OSC_SNAPSHOT_ADDRESS
+    void setSnapshotRequests(bool enabled);
+    uint64_t getSnapshotsRequested() const {return port ? port->getSnapshotsRequested() : 0;};
+
+    bool hasWaitingMessages();
+    size_t getNumWaitingMessages();
+    bool getNextMessage(ofxOscMessage &message);
+    // Swaps out everything received so far in one step, frames that timed out
+    // included. Messages of a frame are always taken together.
+    bool takeMessages(std::deque<ofxOscMessage> &taken);
+    oscFrameStats getFrameStats() const {return frameAssembler.getStats();};
+
+    // Raw packets this receiver's port reads are appended to recorder, null to stop
+    void setRecorder(oscCaptureRecorder *recorder);
+    // Decodes a packet as if it had arrived on the port, used to replay captures
+    bool injectPacket(const char *data, size_t size);
+    // Forgets every sequence and frame seen so far, so packets can be replayed
+    // again from any point. Only while stopped, stop() also calls it.
+    void resetTracking();
+
+    // Called on the receive thread with every accepted message as it arrives,
+    // before frames are assembled. Empty to remove, it must not block.
+    void setObserver(std::function<void(const ofxOscMessage&)> observer);
+
+    const oscEndpoint &getEndpoint() const {return endpoint;};
+
+private:
+    friend class oscReceivePort;
+    // Only messages of packets the sequence tracker accepted get here
+    void pushMessage(ofxOscMessage &&message, const oscFrameInfo &frame);
+
+    oscEndpoint endpoint;
+    std::string prefix;
+    std::shared_ptr<oscReceivePort> port;
+    std::vector<std::pair<std::string, std::string>> joinedGroups;
+    int receiveBufferSize = 0;
+    bool snapshotRequests = false;
+    oscCaptureRecorder *recorder = nullptr;
+    oscSequenceTracker sequenceTracker;
+
+    std::mutex messagesMutex;
+    std::deque<ofxOscMessage> messages;
+    oscFrameAssembler frameAssembler;
+    std::function<void(const ofxOscMessage&)> observer;
+};
+
+#endif /* oscTransport_h */
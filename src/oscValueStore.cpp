@@ -0,0 +1,130 @@
+//
+//  oscValueStore.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscValueStore.h"
+#include "oscTransport.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+oscValueStore::~oscValueStore(){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    condition.notify_one();
+    if(thread.joinable()){
+        thread.join();
+    }
+}
+
+bool oscValueStore::load(const std::string &path, std::vector<ofxOscMessage> &messages){
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) return false;
+    std::vector<char> file;
+    struct stat info;
+    if(fstat(fd, &info) == 0 && info.st_size >= OSC_VALUES_HEADER_SIZE){
+        file.resize(info.st_size);
+        size_t read = 0;
+        while(read < file.size()){
+            ssize_t result = ::read(fd, file.data() + read, file.size() - read);
+            if(result < 0 && errno == EINTR) continue;
+            if(result <= 0) break;
+            read += result;
+        }
+        file.resize(read);
+    }
+    ::close(fd);
+
+    uint32_t version = 0, size = 0;
+    if(file.size() >= OSC_VALUES_HEADER_SIZE){
+        memcpy(&version, file.data() + 4, sizeof(version));
+        memcpy(&size, file.data() + 8, sizeof(size));
+    }
+    if(file.size() < OSC_VALUES_HEADER_SIZE || memcmp(file.data(), OSC_VALUES_MAGIC, 4) != 0
+       || version != OSC_VALUES_VERSION || OSC_VALUES_HEADER_SIZE + size_t(size) > file.size()){
+        ofLogError("oscValueStore") << path << " is not a values file, or of an unknown version";
+        return false;
+    }
+    return oscPacketReader::read(file.data() + OSC_VALUES_HEADER_SIZE, size, messages);
+}
+
+void oscValueStore::checkpoint(const std::string &path, const char *data, size_t size){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingPath = path;
+        pending.assign(data, data + size);
+        hasPending = true;
+        if(!running){
+            if(thread.joinable()) thread.join();
+            running = true;
+            thread = std::thread(&oscValueStore::threadedFunction, this);
+        }
+    }
+    condition.notify_one();
+}
+
+void oscValueStore::threadedFunction(){
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true){
+        condition.wait(lock, [this]{return hasPending || !running;});
+        if(!hasPending) break;
+        std::string path = std::move(pendingPath);
+        std::vector<char> bundle;
+        bundle.swap(pending);
+        hasPending = false;
+        lock.unlock();
+        // Most checkpoints of an idle group are identical, skip the disk for those
+        if(path != writtenPath || bundle != written){
+            if(write(path, bundle)){
+                writtenPath = path;
+                written.swap(bundle);
+            }
+        }
+        lock.lock();
+    }
+}
+
+bool oscValueStore::write(const std::string &path, const std::vector<char> &bundle){
+    std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0){
+        ofLogError("oscValueStore") << "Could not open " << temporary << ": " << strerror(errno);
+        return false;
+    }
+    uint32_t version = OSC_VALUES_VERSION;
+    uint32_t size = bundle.size();
+    std::vector<char> file;
+    file.reserve(OSC_VALUES_HEADER_SIZE + bundle.size());
+    file.insert(file.end(), OSC_VALUES_MAGIC, OSC_VALUES_MAGIC + 4);
+    file.insert(file.end(), reinterpret_cast<const char*>(&version), reinterpret_cast<const char*>(&version) + sizeof(version));
+    file.insert(file.end(), reinterpret_cast<const char*>(&size), reinterpret_cast<const char*>(&size) + sizeof(size));
+    file.insert(file.end(), bundle.begin(), bundle.end());
+
+    size_t written = 0;
+    while(written < file.size()){
+        ssize_t result = ::write(fd, file.data() + written, file.size() - written);
+        if(result < 0){
+            if(errno == EINTR) continue;
+            ofLogError("oscValueStore") << "Write to " << temporary << " failed: " << strerror(errno);
+            ::close(fd);
+            ::unlink(temporary.c_str());
+            return false;
+        }
+        written += result;
+    }
+    ::close(fd);
+    if(::rename(temporary.c_str(), path.c_str()) != 0){
+        ofLogError("oscValueStore") << "Could not replace " << path << ": " << strerror(errno);
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,59 @@
+//
+//  oscValueStore.h
+//  ofxOceanodeOsc
+//
+//  Binary sidecar with the last values of a group, so they survive a restart.
+//  The values are stored the way they travel: one OSC bundle with the message
+//  each variable would send, encoded by its codec. Restoring is a single read
+//  and a pass of binary decoding, with no text parsing even for big vectors.
+//
+//  Layout: "OSCV" | u32 version | u32 bundle size | bundle
+//
+//  Checkpoints are written by a background thread to "<path>.tmp" and renamed
+//  over the file, so a crash never leaves a half written one behind.
+//
+
+#ifndef oscValueStore_h
+#define oscValueStore_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#define OSC_VALUES_MAGIC "OSCV"
+#define OSC_VALUES_VERSION 1
+#define OSC_VALUES_HEADER_SIZE 12
+// How often groups that persist their values checkpoint them
+#define OSC_VALUES_CHECKPOINT_MS 2000
+
+class oscValueStore {
+public:
+    // Writes whatever is still pending before returning
+    ~oscValueStore();
+
+    // Messages saved at path, false if there is no valid file
+    static bool load(const std::string &path, std::vector<ofxOscMessage> &messages);
+
+    // Queues the bundle for the writer thread and returns at once. A newer
+    // checkpoint replaces one not written yet, one equal to the last written is dropped.
+    void checkpoint(const std::string &path, const char *data, size_t size);
+
+private:
+    void threadedFunction();
+    static bool write(const std::string &path, const std::vector<char> &bundle);
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool running = false;
+    bool hasPending = false;
+    std::string pendingPath;
+    std::vector<char> pending;
+    std::string writtenPath;
+    std::vector<char> written;
+};
+
+#endif /* oscValueStore_h */
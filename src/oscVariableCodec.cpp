@@ -0,0 +1,67 @@
+//
+//  oscVariableCodec.cpp
+//  ofxOceanodeOsc
+//
+
+#include "oscVariableCodec.h"
+
+const std::vector<const oscVariableType*> &oscVariableTypes::all(){
+    static const std::vector<const oscVariableType*> types = {
+        &oscVariableTypeOf<float>(),
+        &oscVariableTypeOf<std::vector<float>>(),
+        &oscVariableTypeOf<int>(),
+        &oscVariableTypeOf<std::vector<int>>(),
+        &oscVariableTypeOf<std::string>(),
+        &oscVariableTypeOf<std::vector<std::string>>(),
+        &oscVariableTypeOf<bool>(),
+        &oscVariableTypeOf<double>(),
+        &oscVariableTypeOf<std::vector<double>>(),
+        &oscVariableTypeOf<int64_t>(),
+        &oscVariableTypeOf<ofColor>(),
+        &oscVariableTypeOf<glm::vec3>(),
+    };
+    return types;
+}
+
+const oscVariableType *oscVariableTypes::find(const std::string &name){
+    for(auto type : all()){
+        if(name == type->name) return type;
+    }
+    return nullptr;
+}
+
+const oscVariableType *oscVariableTypes::infer(const std::string &typeTags, uint32_t maxArgs, bool mixed){
+    if(typeTags.empty()) return nullptr;
+    bool strings = true, integers = true, doubles = true, numbers = true;
+    for(char tag : typeTags){
+        bool isString = tag == OFXOSC_TYPE_STRING || tag == OFXOSC_TYPE_SYMBOL;
+        bool isInteger = tag == OFXOSC_TYPE_INT32 || tag == OFXOSC_TYPE_INT64;
+        bool isNumber = isInteger || tag == OFXOSC_TYPE_FLOAT || tag == OFXOSC_TYPE_DOUBLE || tag == OFXOSC_TYPE_TRUE || tag == OFXOSC_TYPE_FALSE;
+        strings &= isString;
+        integers &= isInteger;
+        doubles &= tag == OFXOSC_TYPE_DOUBLE;
+        numbers &= isNumber;
+    }
+    
+    if(maxArgs <= 1){
+        if(mixed) return numbers ? &oscVariableTypeOf<float>() : nullptr;
+        switch(typeTags[0]){
+            case OFXOSC_TYPE_FLOAT: return &oscVariableTypeOf<float>();
+            case OFXOSC_TYPE_DOUBLE: return &oscVariableTypeOf<double>();
+            case OFXOSC_TYPE_INT32: return &oscVariableTypeOf<int>();
+            case OFXOSC_TYPE_INT64: return &oscVariableTypeOf<int64_t>();
+            case OFXOSC_TYPE_TRUE:
+            case OFXOSC_TYPE_FALSE: return &oscVariableTypeOf<bool>();
+            case OFXOSC_TYPE_STRING:
+            case OFXOSC_TYPE_SYMBOL: return &oscVariableTypeOf<std::string>();
+            case OFXOSC_TYPE_RGBA_COLOR: return &oscVariableTypeOf<ofColor>();
+            default: return nullptr;
+        }
+    }
+    
+    if(strings && !mixed) return &oscVariableTypeOf<std::vector<std::string>>();
+    if(!numbers) return nullptr;
+    if(integers && !mixed) return &oscVariableTypeOf<std::vector<int>>();
+    if(doubles && !mixed) return &oscVariableTypeOf<std::vector<double>>();
+    return &oscVariableTypeOf<std::vector<float>>();
+}
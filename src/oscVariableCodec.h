@@ -0,0 +1,426 @@
+//
+//  oscVariableCodec.h
+//  ofxOceanodeOsc
+//
+//  Everything a variable type needs, generated per C++ type from one
+//  oscVariableCodec<T> specialization: OSC encoder and decoder, the name saved
+//  in oscVars.json and the panel labels. Each variable keeps a pointer to its
+//  oscVariableType, so the send and receive paths call straight into the
+//  right codec with a static_cast instead of testing types at runtime.
+//
+//  Decoders coerce numeric arguments (int, int64, float, double, bool) to the
+//  variable type, so a client sending 1 to a float variable is not dropped.
+//
+
+#ifndef oscVariableCodec_h
+#define oscVariableCodec_h
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+#include "oscQuantize.h"
+
+#include <cmath>
+
+//-------------------------------------------------------------------------
+// Numeric argument coercion
+//-------------------------------------------------------------------------
+namespace oscVariableArgs {
+    inline bool isNumeric(ofxOscArgType type){
+        switch(type){
+            case OFXOSC_TYPE_INT32:
+            case OFXOSC_TYPE_INT64:
+            case OFXOSC_TYPE_FLOAT:
+            case OFXOSC_TYPE_DOUBLE:
+            case OFXOSC_TYPE_TRUE:
+            case OFXOSC_TYPE_FALSE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    inline bool isInteger(ofxOscArgType type){
+        return type == OFXOSC_TYPE_INT32 || type == OFXOSC_TYPE_INT64 || type == OFXOSC_TYPE_TRUE || type == OFXOSC_TYPE_FALSE;
+    }
+
+    // Exact for integer arguments, floating point ones are rounded
+    inline bool asInt64(const ofxOscMessage &message, size_t index, int64_t &value){
+        switch(message.getArgType(index)){
+            case OFXOSC_TYPE_INT32: value = message.getArgAsInt32(index); return true;
+            case OFXOSC_TYPE_INT64: value = message.getArgAsInt64(index); return true;
+            case OFXOSC_TYPE_FLOAT: value = std::llround(message.getArgAsFloat(index)); return true;
+            case OFXOSC_TYPE_DOUBLE: value = std::llround(message.getArgAsDouble(index)); return true;
+            case OFXOSC_TYPE_TRUE: value = 1; return true;
+            case OFXOSC_TYPE_FALSE: value = 0; return true;
+            default: return false;
+        }
+    }
+
+    inline bool asDouble(const ofxOscMessage &message, size_t index, double &value){
+        switch(message.getArgType(index)){
+            case OFXOSC_TYPE_FLOAT: value = message.getArgAsFloat(index); return true;
+            case OFXOSC_TYPE_DOUBLE: value = message.getArgAsDouble(index); return true;
+            case OFXOSC_TYPE_INT32: value = message.getArgAsInt32(index); return true;
+            case OFXOSC_TYPE_INT64: value = double(message.getArgAsInt64(index)); return true;
+            case OFXOSC_TYPE_TRUE: value = 1; return true;
+            case OFXOSC_TYPE_FALSE: value = 0; return true;
+            default: return false;
+        }
+    }
+
+    inline bool asString(const ofxOscMessage &message, size_t index, std::string &value){
+        ofxOscArgType type = message.getArgType(index);
+        if(type != OFXOSC_TYPE_STRING && type != OFXOSC_TYPE_SYMBOL) return false;
+        value = message.getArgAsString(index);
+        return true;
+    }
+
+    // Any argument the scalar T accepts, converted
+    template<typename T>
+    bool as(const ofxOscMessage &message, size_t index, T &value){
+        double number;
+        if(!asDouble(message, index, number)) return false;
+        value = T(number);
+        return true;
+    }
+
+    template<>
+    inline bool as<int>(const ofxOscMessage &message, size_t index, int &value){
+        int64_t number;
+        if(!asInt64(message, index, number)) return false;
+        value = int(number);
+        return true;
+    }
+
+    template<>
+    inline bool as<int64_t>(const ofxOscMessage &message, size_t index, int64_t &value){
+        return asInt64(message, index, value);
+    }
+
+    template<>
+    inline bool as<std::string>(const ofxOscMessage &message, size_t index, std::string &value){
+        return asString(message, index, value);
+    }
+
+    // Every convertible argument in order, others are skipped, false if none was.
+    // Decoded in place, reusing the storage of values, which is emptied on false.
+    template<typename T>
+    bool asVector(const ofxOscMessage &message, std::vector<T> &values){
+        values.clear();
+        T value;
+        for(size_t i = 0; i < message.getNumArgs(); i++){
+            if(as(message, i, value)) values.push_back(value);
+        }
+        return !values.empty();
+    }
+}
+
+// Packed group output a variable is copied to, see oscVariablesGroup::packed
+enum class oscPackedLane {
+    None,
+    Float,      // ofParameter<float>
+    Int,        // ofParameter<int>
+    String      // ofParameter<std::string>
+};
+
+//-------------------------------------------------------------------------
+// oscVariableCodec - One specialization per supported variable type
+//
+// name is stored in oscVars.json and must never change, label is shown in
+// the new variable dialog and tag in the variable list.
+//-------------------------------------------------------------------------
+template<typename T>
+struct oscVariableCodec;
+
+template<>
+struct oscVariableCodec<float> {
+    static constexpr const char *name = "float";
+    static constexpr const char *label = "Float";
+    static constexpr const char *tag = "Float";
+    static constexpr oscPackedLane lane = oscPackedLane::Float;
+    static void setup(ofParameter<float> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, 0, -FLT_MAX, FLT_MAX);
+    }
+    static void encode(const float &value, ofxOscMessage &message){message.addFloatArg(value);}
+    static bool decode(const ofxOscMessage &message, float &value){
+        return message.getNumArgs() > 0 && oscVariableArgs::as(message, 0, value);
+    }
+};
+
+template<>
+struct oscVariableCodec<double> {
+    static constexpr const char *name = "double";
+    static constexpr const char *label = "Double";
+    static constexpr const char *tag = "Double";
+    static constexpr oscPackedLane lane = oscPackedLane::None;
+    static void setup(ofParameter<double> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, 0, -DBL_MAX, DBL_MAX);
+    }
+    static void encode(const double &value, ofxOscMessage &message){message.addDoubleArg(value);}
+    static bool decode(const ofxOscMessage &message, double &value){
+        return message.getNumArgs() > 0 && oscVariableArgs::as(message, 0, value);
+    }
+};
+
+template<>
+struct oscVariableCodec<int> {
+    static constexpr const char *name = "int";
+    static constexpr const char *label = "Int";
+    static constexpr const char *tag = "Int";
+    static constexpr oscPackedLane lane = oscPackedLane::Int;
+    static void setup(ofParameter<int> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, 0, INT_MIN, INT_MAX);
+    }
+    static void encode(const int &value, ofxOscMessage &message){message.addIntArg(value);}
+    static bool decode(const ofxOscMessage &message, int &value){
+        return message.getNumArgs() > 0 && oscVariableArgs::as(message, 0, value);
+    }
+};
+
+template<>
+struct oscVariableCodec<int64_t> {
+    static constexpr const char *name = "int64";
+    static constexpr const char *label = "Int64";
+    static constexpr const char *tag = "Int64";
+    static constexpr oscPackedLane lane = oscPackedLane::None;
+    static void setup(ofParameter<int64_t> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, 0, INT64_MIN, INT64_MAX);
+    }
+    static void encode(const int64_t &value, ofxOscMessage &message){message.addInt64Arg(value);}
+    static bool decode(const ofxOscMessage &message, int64_t &value){
+        return message.getNumArgs() > 0 && oscVariableArgs::as(message, 0, value);
+    }
+};
+
+template<>
+struct oscVariableCodec<bool> {
+    static constexpr const char *name = "bool";
+    static constexpr const char *label = "Bool";
+    static constexpr const char *tag = "Bool";
+    static constexpr oscPackedLane lane = oscPackedLane::None;
+    static void setup(ofParameter<bool> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, false);
+    }
+    static void encode(const bool &value, ofxOscMessage &message){message.addBoolArg(value);}
+    // Any non zero number is true
+    static bool decode(const ofxOscMessage &message, bool &value){
+        double number;
+        if(message.getNumArgs() == 0 || !oscVariableArgs::asDouble(message, 0, number)) return false;
+        value = number != 0;
+        return true;
+    }
+};
+
+template<>
+struct oscVariableCodec<std::string> {
+    static constexpr const char *name = "string";
+    static constexpr const char *label = "String";
+    static constexpr const char *tag = "String";
+    static constexpr oscPackedLane lane = oscPackedLane::String;
+    static void setup(ofParameter<std::string> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, "");
+    }
+    static void encode(const std::string &value, ofxOscMessage &message){message.addStringArg(value);}
+    static bool decode(const ofxOscMessage &message, std::string &value){
+        return message.getNumArgs() > 0 && oscVariableArgs::asString(message, 0, value);
+    }
+};
+
+template<>
+struct oscVariableCodec<ofColor> {
+    static constexpr const char *name = "color";
+    static constexpr const char *label = "Color";
+    static constexpr const char *tag = "Color";
+    static constexpr oscPackedLane lane = oscPackedLane::None;
+    static void setup(ofParameter<ofColor> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, ofColor::white, ofColor(0, 0), ofColor(255, 255));
+    }
+    static void encode(const ofColor &value, ofxOscMessage &message){
+        message.addRgbaColorArg((uint32_t(value.r) << 24) | (uint32_t(value.g) << 16) | (uint32_t(value.b) << 8) | uint32_t(value.a));
+    }
+    // An rgba argument, or 3 or 4 numbers: integers in 0..255, floats in 0..1
+    static bool decode(const ofxOscMessage &message, ofColor &value){
+        if(message.getNumArgs() > 0 && message.getArgType(0) == OFXOSC_TYPE_RGBA_COLOR){
+            uint32_t rgba = message.getArgAsRgbaColor(0);
+            value.set(rgba >> 24, (rgba >> 16) & 0xff, (rgba >> 8) & 0xff, rgba & 0xff);
+            return true;
+        }
+        if(message.getNumArgs() < 3) return false;
+        double channels[4] = {0, 0, 0, 1};
+        bool integers = oscVariableArgs::isInteger(message.getArgType(0));
+        for(size_t i = 0; i < std::min<size_t>(message.getNumArgs(), 4); i++){
+            if(!oscVariableArgs::asDouble(message, i, channels[i])) return false;
+            if(!integers) channels[i] *= 255;
+        }
+        if(integers && message.getNumArgs() < 4) channels[3] = 255;
+        value.set(ofClamp(channels[0], 0.0, 255.0), ofClamp(channels[1], 0.0, 255.0), ofClamp(channels[2], 0.0, 255.0), ofClamp(channels[3], 0.0, 255.0));
+        return true;
+    }
+};
+
+template<>
+struct oscVariableCodec<glm::vec3> {
+    static constexpr const char *name = "vec3";
+    static constexpr const char *label = "Vec3";
+    static constexpr const char *tag = "Vec3";
+    static constexpr oscPackedLane lane = oscPackedLane::None;
+    static void setup(ofParameter<glm::vec3> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, glm::vec3(0), glm::vec3(-FLT_MAX), glm::vec3(FLT_MAX));
+    }
+    static void encode(const glm::vec3 &value, ofxOscMessage &message){
+        message.addFloatArg(value.x);
+        message.addFloatArg(value.y);
+        message.addFloatArg(value.z);
+    }
+    static bool decode(const ofxOscMessage &message, glm::vec3 &value){
+        glm::vec3 decoded;
+        if(message.getNumArgs() < 3) return false;
+        for(size_t i = 0; i < 3; i++){
+            if(!oscVariableArgs::as(message, i, decoded[i])) return false;
+        }
+        value = decoded;
+        return true;
+    }
+};
+
+// Vectors send one argument per element, scalar coercion applies to each of them
+template<typename T>
+struct oscVariableVectorCodec {
+    static constexpr oscPackedLane lane = oscPackedLane::None;
+    static void encode(const std::vector<T> &values, ofxOscMessage &message){
+        for(const auto &value : values) oscVariableCodec<T>::encode(value, message);
+    }
+    static bool decode(const ofxOscMessage &message, std::vector<T> &values){
+        return oscVariableArgs::asVector(message, values);
+    }
+};
+
+template<>
+struct oscVariableCodec<std::vector<float>> : oscVariableVectorCodec<float> {
+    static constexpr const char *name = "float_vector";
+    static constexpr const char *label = "Float Vector";
+    static constexpr const char *tag = "Vec.Float";
+    static void setup(ofParameter<std::vector<float>> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, {0}, {FLT_MIN}, {FLT_MAX});
+        parameter.setSerializable(true);
+    }
+    // Also a single quantized blob from a sender with a compact wire format, see oscQuantize.h
+    static bool decode(const ofxOscMessage &message, std::vector<float> &values){
+        if(message.getNumArgs() == 1 && message.getArgType(0) == OFXOSC_TYPE_BLOB){
+            const ofBuffer &blob = message.getArgAsBlob(0);
+            return oscQuantizer::decode(blob.getData(), blob.size(), values);
+        }
+        return oscVariableArgs::asVector(message, values);
+    }
+};
+
+template<>
+struct oscVariableCodec<std::vector<double>> : oscVariableVectorCodec<double> {
+    static constexpr const char *name = "double_vector";
+    static constexpr const char *label = "Double Vector";
+    static constexpr const char *tag = "Vec.Double";
+    static void setup(ofParameter<std::vector<double>> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, {0}, {-DBL_MAX}, {DBL_MAX});
+        parameter.setSerializable(true);
+    }
+};
+
+template<>
+struct oscVariableCodec<std::vector<int>> : oscVariableVectorCodec<int> {
+    static constexpr const char *name = "int_vector";
+    static constexpr const char *label = "Int Vector";
+    static constexpr const char *tag = "Vec.Int";
+    static void setup(ofParameter<std::vector<int>> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, {0}, {INT_MIN}, {INT_MAX});
+        parameter.setSerializable(true);
+    }
+};
+
+template<>
+struct oscVariableCodec<std::vector<std::string>> : oscVariableVectorCodec<std::string> {
+    static constexpr const char *name = "string_vector";
+    static constexpr const char *label = "String Vector";
+    static constexpr const char *tag = "Vec.String";
+    static void setup(ofParameter<std::vector<std::string>> &parameter, const std::string &parameterName){
+        parameter.set(parameterName, std::vector<std::string>());
+    }
+};
+
+//-------------------------------------------------------------------------
+// oscVariableType - Type erased view of one codec, shared by all its variables
+//-------------------------------------------------------------------------
+struct oscVariableType {
+    const char *name;
+    const char *label;
+    const char *tag;
+    oscPackedLane lane;
+
+    std::shared_ptr<ofAbstractParameter> (*create)(const std::string &parameterName);
+    void (*encode)(const ofAbstractParameter &parameter, ofxOscMessage &message);
+    // Leaves the parameter untouched if nothing in the message converts to its type
+    bool (*decode)(const ofxOscMessage &message, ofAbstractParameter &parameter);
+    // decode without notifying, notify() runs the listeners once a whole batch is set
+    bool (*stage)(const ofxOscMessage &message, ofAbstractParameter &parameter);
+    void (*notify)(ofAbstractParameter &parameter);
+    // changed runs after every change, the group encodes the value in the variable's wire format
+    ofEventListener (*listen)(ofAbstractParameter &parameter, std::function<void()> changed);
+};
+
+template<typename T>
+const oscVariableType &oscVariableTypeOf(){
+    typedef oscVariableCodec<T> Codec;
+    static const oscVariableType type = {
+        Codec::name,
+        Codec::label,
+        Codec::tag,
+        Codec::lane,
+        [](const std::string &parameterName) -> std::shared_ptr<ofAbstractParameter> {
+            auto parameter = std::make_shared<ofParameter<T>>();
+            Codec::setup(*parameter, parameterName);
+            return parameter;
+        },
+        [](const ofAbstractParameter &parameter, ofxOscMessage &message){
+            Codec::encode(static_cast<const ofParameter<T>&>(parameter).get(), message);
+        },
+        [](const ofxOscMessage &message, ofAbstractParameter &parameter){
+            // Kept per thread, so vectors decode into the storage of the previous message
+            // and only the assignment below copies. A failed decode only spoils the scratch.
+            static thread_local T value;
+            if(!Codec::decode(message, value)) return false;
+            static_cast<ofParameter<T>&>(parameter) = value;
+            return true;
+        },
+        [](const ofxOscMessage &message, ofAbstractParameter &parameter){
+            static thread_local T value;
+            if(!Codec::decode(message, value)) return false;
+            static_cast<ofParameter<T>&>(parameter).setWithoutEventNotifications(value);
+            return true;
+        },
+        [](ofAbstractParameter &parameter){
+            // Setting the current value again notifies every listener
+            auto &typed = static_cast<ofParameter<T>&>(parameter);
+            typed = typed.get();
+        },
+        [](ofAbstractParameter &parameter, std::function<void()> changed){
+            return static_cast<ofParameter<T>&>(parameter).newListener([changed](T &){
+                changed();
+            });
+        }
+    };
+    return type;
+}
+
+//-------------------------------------------------------------------------
+// oscVariableTypes - Registry of every type a group variable can have
+//-------------------------------------------------------------------------
+namespace oscVariableTypes {
+    // In the order of the new variable dialog
+    const std::vector<const oscVariableType*> &all();
+    // By the name saved in oscVars.json, null if unknown
+    const oscVariableType *find(const std::string &name);
+    // Best match for messages seen with these type tags, null if none fits.
+    // Numbers that changed type (mixed) become floats, several numbers a vector.
+    const oscVariableType *infer(const std::string &typeTags, uint32_t maxArgs, bool mixed);
+}
+
+#endif /* oscVariableCodec_h */
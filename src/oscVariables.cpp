@@ -32,14 +32,6 @@ void oscVariables::setup() {
     }
 }
 
-void oscVariables::update(ofEventArgs& e)
-{
-    if(auto groupPtr = group.lock()) 
-    {
-        groupPtr->update();
-    }
-}
-
 shared_ptr<ofxOceanodeAbstractParameter> oscVariables::addParameter(ofAbstractParameter& param, ofxOceanodeParameterFlags flags) {
     auto result = ofxOceanodeNodeModel::addParameter(param, flags);
     if(!result) {
@@ -48,91 +40,16 @@ shared_ptr<ofxOceanodeAbstractParameter> oscVariables::addParameter(ofAbstractPa
     }
     
     try {
-        // Handle float parameters
-        auto* floatParam = dynamic_cast<ofParameter<float>*>(&param);
-        if(floatParam != nullptr) {
-            auto listener = floatParam->newListener([this, paramName = param.getName()](float& value) {
-                auto sharedGroup = group.lock();
-                if(sharedGroup && sharedGroup->oscMode == OscMode::Sender) {
-                    ofxOscMessage msg;
-                    msg.setAddress("/" + paramName);
-                    msg.addFloatArg(value);
-                    sharedGroup->sender.sendMessage(msg);
-                }
-            });
-            parameterListeners[param.getName()] = std::make_shared<ofEventListener>(std::move(listener));
-        }
-        auto* intParam = dynamic_cast<ofParameter<int>*>(&param);
-        if(intParam != nullptr) {
-            auto listener = intParam->newListener([this, paramName = param.getName()](int& value) {
-                auto sharedGroup = group.lock();
-                if(sharedGroup && sharedGroup->oscMode == OscMode::Sender) {
-                    ofxOscMessage msg;
-                    msg.setAddress("/" + paramName);
-                    msg.addIntArg(value);
-                    sharedGroup->sender.sendMessage(msg);
-                }
-            });
-            parameterListeners[param.getName()] = std::make_shared<ofEventListener>(std::move(listener));
-        }
-        // Handle string parameters
-        auto* stringParam = dynamic_cast<ofParameter<string>*>(&param);
-        if(stringParam != nullptr) {
-            auto listener = stringParam->newListener([this, paramName = param.getName()](string& value) {
-                auto sharedGroup = group.lock();
-                if(sharedGroup && sharedGroup->oscMode == OscMode::Sender) {
-                    ofxOscMessage msg;
-                    msg.setAddress("/" + paramName);
-                    msg.addStringArg(value);
-                    sharedGroup->sender.sendMessage(msg);
-                }
-            });
-            parameterListeners[param.getName()] = std::make_shared<ofEventListener>(std::move(listener));
-        }
-        
-        // Handle vector<float> parameters
-        auto* floatVectorParam = dynamic_cast<ofParameter<vector<float>>*>(&param);
-        if(floatVectorParam != nullptr) {
-            auto listener = floatVectorParam->newListener([this, paramName = param.getName()](vector<float>& values) {
-                auto sharedGroup = group.lock();
-                if(sharedGroup && sharedGroup->oscMode == OscMode::Sender) {
-                    ofxOscMessage msg;
-                    msg.setAddress("/" + paramName);
-                    for(const auto& value : values) {
-                        msg.addFloatArg(value);
-                    }
-                    sharedGroup->sender.sendMessage(msg);
-                }
-            });
-            parameterListeners[param.getName()] = std::make_shared<ofEventListener>(std::move(listener));
-        }
-        auto* intVectorParam = dynamic_cast<ofParameter<vector<int>>*>(&param);
-        if(intVectorParam != nullptr) {
-            auto listener = intVectorParam->newListener([this, paramName = param.getName()](vector<int>& values) {
-                auto sharedGroup = group.lock();
-                if(sharedGroup && sharedGroup->oscMode == OscMode::Sender) {
-                    ofxOscMessage msg;
-                    msg.setAddress("/" + paramName);
-                    for(const auto& value : values) {
-                        msg.addIntArg(value);
-                    }
-                    sharedGroup->sender.sendMessage(msg);
-                }
-            });
-            parameterListeners[param.getName()] = std::make_shared<ofEventListener>(std::move(listener));
-        }
-        // Handle vector<string> parameters
-        auto* stringVectorParam = dynamic_cast<ofParameter<vector<string>>*>(&param);
-        if(stringVectorParam != nullptr) {
-            auto listener = stringVectorParam->newListener([this, paramName = param.getName()](vector<string>& values) {
+        // Only group variables are sent, and only by senders
+        auto sharedGroup = group.lock();
+        auto table = sharedGroup ? sharedGroup->getParameters() : nullptr;
+        const oscVariable *variable = table ? table->find(param.getName()) : nullptr;
+        if(variable != nullptr && sharedGroup->oscMode == OscMode::Sender) {
+            auto listener = variable->type->listen(param, [this, parameterName = param.getName()]() {
                 auto sharedGroup = group.lock();
-                if(sharedGroup && sharedGroup->oscMode == OscMode::Sender) {
-                    ofxOscMessage msg;
-                    msg.setAddress("/" + paramName);
-                    for(const auto& value : values) {
-                        msg.addStringArg(value);
-                    }
-                    sharedGroup->sender.sendMessage(msg);
+                if(sharedGroup) {
+                    OSC_TRACE_SCOPE("osc.notify");
+                    sharedGroup->sendParameter(parameterName);
                 }
             });
             parameterListeners[param.getName()] = std::make_shared<ofEventListener>(std::move(listener));
@@ -11,7 +11,6 @@ public:
     ~oscVariables();
     
     void setup() override;
-    void update(ofEventArgs& e) override; // Add the update method
     
     shared_ptr<ofxOceanodeAbstractParameter> addParameter(ofAbstractParameter& param, ofxOceanodeParameterFlags flags = 0);
     std::weak_ptr<oscVariablesGroup> getGroup() {return group;};